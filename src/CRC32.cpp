@@ -0,0 +1,208 @@
+//============================================================================
+// Name        : CRC32.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Table-driven and carry-less-multiply CRC-32 engine.
+//============================================================================
+
+#include "src/CRC32.hpp"
+#include "src/Cpu.hpp"
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace framegen {
+
+    // All CRCs here are reflected (LSB first). The kernels compute the "raw" CRC, without the initial and final
+    // inversion zlib applies.
+    static const uint32_t zlib_polynomial = 0xEDB88320;
+
+    namespace {
+        inline uint32_t load32(const uint8_t* p) {
+            return (uint32_t)p[0] | (uint32_t)p[1]<<8 | (uint32_t)p[2]<<16 | (uint32_t)p[3]<<24;
+        }
+
+        //=============
+        // Slice-by-8
+        //=============
+        struct Tables {
+            uint32_t t[8][256];
+
+            explicit Tables(const uint32_t polynomial) {
+                for(unsigned i=0; i<256; i++) {
+                    uint32_t c = i;
+                    for(int k=0; k<8; k++)
+                        c = c&1 ? (c>>1)^polynomial : c>>1;
+                    t[0][i] = c;
+                }
+                for(unsigned i=0; i<256; i++)
+                    for(unsigned k=1; k<8; k++)
+                        t[k][i] = (t[k-1][i]>>8) ^ t[0][t[k-1][i]&0xFF];
+            }
+        };
+
+        const Tables& tables(const uint32_t polynomial) {
+            static const Tables zlibTables(zlib_polynomial);
+            if(polynomial == zlib_polynomial)
+                return zlibTables;
+            // Other polynomials are built once on first use.
+            static std::mutex mutex;
+            static std::map<uint32_t, std::unique_ptr<Tables> > cache;
+            std::lock_guard<std::mutex> lock(mutex);
+            std::unique_ptr<Tables>& entry = cache[polynomial];
+            if(!entry)
+                entry.reset(new Tables(polynomial));
+            return *entry;
+        }
+
+        uint32_t raw_slice8(const Tables& tab, uint32_t crc, const uint8_t* p, size_t n) {
+            const uint32_t (&t)[8][256] = tab.t;
+            for(; n>=8; p+=8, n-=8) {
+                const uint32_t one = load32(p) ^ crc;
+                const uint32_t two = load32(p+4);
+                crc = t[7][one&0xFF] ^ t[6][(one>>8)&0xFF] ^ t[5][(one>>16)&0xFF] ^ t[4][one>>24]
+                    ^ t[3][two&0xFF] ^ t[2][(two>>8)&0xFF] ^ t[1][(two>>16)&0xFF] ^ t[0][two>>24];
+            }
+            for(; n; p++, n--)
+                crc = (crc>>8) ^ t[0][(crc^*p)&0xFF];
+            return crc;
+        }
+
+        // Advance the register over four zero bytes.
+        inline uint32_t raw_zero32(const Tables& tab, const uint32_t crc) {
+            return tab.t[3][crc&0xFF] ^ tab.t[2][(crc>>8)&0xFF] ^ tab.t[1][(crc>>16)&0xFF] ^ tab.t[0][crc>>24];
+        }
+
+#ifdef FRAMEGEN_X86
+        //========================
+        // Carry-less multiply
+        //========================
+        // Folding constants for the zlib polynomial, following Intel's "Fast CRC Computation for Generic Polynomials
+        // Using PCLMULQDQ Instruction". Needs at least 64 bytes; returns the number of bytes consumed (a multiple of
+        // 16) and leaves the rest to the table kernel.
+        FRAMEGEN_TARGET("pclmul,sse4.1")
+        size_t raw_pclmul(uint32_t& crc, const uint8_t* p, size_t n) {
+            if(n<64)
+                return 0;
+            const size_t length = n & ~(size_t)15;
+            const uint8_t* end = p + length;
+            const __m128i* q = reinterpret_cast<const __m128i*>(p);
+
+            __m128i x1 = _mm_xor_si128(_mm_loadu_si128(q), _mm_cvtsi32_si128(crc));
+            __m128i x2 = _mm_loadu_si128(q+1);
+            __m128i x3 = _mm_loadu_si128(q+2);
+            __m128i x4 = _mm_loadu_si128(q+3);
+            p += 64;
+
+            // Fold 64 bytes at a time.
+            __m128i k = _mm_set_epi64x(0x1c6e41596, 0x154442bd4);
+            for(; end-p >= 64; p+=64) {
+                q = reinterpret_cast<const __m128i*>(p);
+                x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k, 0x00), _mm_clmulepi64_si128(x1, k, 0x11)),
+                                   _mm_loadu_si128(q));
+                x2 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x2, k, 0x00), _mm_clmulepi64_si128(x2, k, 0x11)),
+                                   _mm_loadu_si128(q+1));
+                x3 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x3, k, 0x00), _mm_clmulepi64_si128(x3, k, 0x11)),
+                                   _mm_loadu_si128(q+2));
+                x4 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x4, k, 0x00), _mm_clmulepi64_si128(x4, k, 0x11)),
+                                   _mm_loadu_si128(q+3));
+            }
+
+            // Fold the four accumulators into one, then the remaining 16-byte blocks.
+            k = _mm_set_epi64x(0x0ccaa009e, 0x1751997d0);
+            x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k, 0x00), _mm_clmulepi64_si128(x1, k, 0x11)), x2);
+            x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k, 0x00), _mm_clmulepi64_si128(x1, k, 0x11)), x3);
+            x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k, 0x00), _mm_clmulepi64_si128(x1, k, 0x11)), x4);
+            for(; p<end; p+=16)
+                x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k, 0x00), _mm_clmulepi64_si128(x1, k, 0x11)),
+                                   _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+
+            // 128 -> 64 bits.
+            x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, k, 0x10), _mm_srli_si128(x1, 8));
+            // 64 -> 32 bits.
+            const __m128i mask32 = _mm_set_epi32(0, 0, 0, -1);
+            k = _mm_set_epi64x(0, 0x163cd6124);
+            x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x00), _mm_srli_si128(x1, 4));
+            // Barrett reduction to the final 32-bit remainder.
+            k = _mm_set_epi64x(0x1F7011641, 0x1DB710641);
+            __m128i x = _mm_and_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x10), mask32);
+            x1 = _mm_xor_si128(x1, _mm_clmulepi64_si128(x, k, 0x00));
+            crc = _mm_extract_epi32(x1, 1);
+            return length;
+        }
+#endif
+
+        //==========
+        // Dispatch
+        //==========
+        typedef size_t (*fold_fn)(uint32_t&, const uint8_t*, size_t);
+
+        size_t no_fold(uint32_t&, const uint8_t*, size_t) { return 0; }
+
+        struct CRCKernel {
+            fold_fn fold; // Bulk kernel for the zlib polynomial; leaves a tail for the tables.
+            const char* name;
+        };
+
+        CRCKernel selectKernel() {
+#ifdef FRAMEGEN_X86
+            if(cpu::supports_pclmul()) {
+                CRCKernel k = {raw_pclmul, "pclmul"};
+                return k;
+            }
+#endif
+            CRCKernel k = {no_fold, "slice-by-8"};
+            return k;
+        }
+
+        const CRCKernel& kernel() {
+            static const CRCKernel k = selectKernel();
+            return k;
+        }
+
+        uint32_t raw(const uint32_t polynomial, uint32_t crc, const uint8_t* p, size_t n) {
+            if(polynomial == zlib_polynomial) {
+                const size_t done = kernel().fold(crc, p, n);
+                p += done;
+                n -= done;
+            }
+            return raw_slice8(tables(polynomial), crc, p, n);
+        }
+    } // namespace
+
+    uint32_t zcrc32(uint32_t crc, const void* data, size_t length) {
+        return ~raw(zlib_polynomial, ~crc, static_cast<const uint8_t*>(data), length);
+    }
+
+    // Covers words 0 through num_frame_words-3, as Frame::calculate_zCRC32() always has.
+    uint32_t zcrc32_frame(const word_t* frame) { return zcrc32(0, frame, (num_frame_words-2)*4); }
+
+    // Frame::calculate_CRC32() starts with word 0 in the register and shifts words 1 through num_frame_words-2 in
+    // without augmentation. Shifting a word in equals XOR-ing it into the register after the register has advanced
+    // over 32 zero bits, so the result is the last word XOR-ed with the raw CRC of a zero word plus the words in
+    // between, started from the (once reduced) first word.
+    uint32_t crc32_frame(const word_t* frame, uint32_t polynomial) {
+        const Tables& tab = tables(polynomial);
+        uint32_t crc = frame[0];
+        if(crc&1)
+            crc ^= polynomial;
+        crc = raw_zero32(tab, crc);
+        crc = raw(polynomial, crc, reinterpret_cast<const uint8_t*>(frame+1), (num_frame_words-3)*4);
+        return frame[num_frame_words-2] ^ crc;
+    }
+
+    void zcrc32_frames(const word_t* frames, size_t Nframes, uint32_t* out) {
+        for(size_t i=0; i<Nframes; i++)
+            out[i] = zcrc32_frame(frames + i*num_frame_words);
+    }
+
+    void crc32_frames(const word_t* frames, size_t Nframes, uint32_t* out, uint32_t polynomial) {
+        for(size_t i=0; i<Nframes; i++)
+            out[i] = crc32_frame(frames + i*num_frame_words, polynomial);
+    }
+
+    const char* crc32_kernel() { return kernel().name; }
+
+} // namespace framegen
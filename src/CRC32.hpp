@@ -0,0 +1,39 @@
+//==========================================================================
+// Name        : CRC32.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Table-driven and carry-less-multiply CRC-32 engine.
+//============================================================================
+
+#ifndef FRAMEGEN_CRC32_HPP_
+#define FRAMEGEN_CRC32_HPP_
+
+#include <cstddef>
+
+#include "Types.hpp"
+
+namespace framegen {
+
+// zlib-compatible CRC-32 of a buffer; same result as zlib's
+// crc32(crc, data, length).
+uint32_t zcrc32(uint32_t crc, const void* data, size_t length);
+
+// CRCs with the same coverage as Frame::calculate_zCRC32() and
+// Frame::calculate_CRC32() (without padding).
+uint32_t zcrc32_frame(const word_t* frame);
+uint32_t crc32_frame(const word_t* frame,
+                     uint32_t polynomial = CRC32_POLYNOMIAL);
+
+// Batch versions for Nframes contiguous frames; out receives one CRC per
+// frame.
+void zcrc32_frames(const word_t* frames, size_t Nframes, uint32_t* out);
+void crc32_frames(const word_t* frames, size_t Nframes, uint32_t* out,
+                  uint32_t polynomial = CRC32_POLYNOMIAL);
+
+// Name of the kernel selected for this CPU ("pclmul" or "slice-by-8").
+const char* crc32_kernel();
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_CRC32_HPP_ */
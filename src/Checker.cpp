@@ -0,0 +1,349 @@
+//============================================================================
+// Name        : Checker.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Parallel frame file verification with structured reports.
+//============================================================================
+
+#include "src/Checker.hpp"
+#include "src/FrameFile.hpp"
+#include "src/Format.hpp"
+#include "src/Verify.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace framegen {
+
+    namespace {
+        // A range of frames of an open file, verified by whichever worker takes it.
+        struct Chunk {
+            std::shared_ptr<FrameFile> file;
+            size_t index; // Of the file.
+            size_t first, count;
+        };
+
+        // Frame number and status of a frame with findings, for printing.
+        typedef std::pair<size_t, uint32_t> Flagged;
+
+        // Add the findings of frames [first, first+count) to the counts of a report.
+        void summarise(const uint32_t* status, const size_t count, const size_t first, FileReport& report,
+                       std::vector<Flagged>* flagged) {
+            for(size_t i=0; i<count; i++) {
+                if(!status[i])
+                    continue;
+                if(flagged)
+                    flagged->push_back(Flagged(first+i, status[i]));
+                for(unsigned blk=0; blk<4; blk++) {
+                    report.checksumAFailures += (status[i] & (status_checksum_a<<blk)) != 0;
+                    report.checksumBFailures += (status[i] & (status_checksum_b<<blk)) != 0;
+                    report.s1Errors += (status[i] & (status_s1_error<<blk)) != 0;
+                    report.s2Errors += (status[i] & (status_s2_error<<blk)) != 0;
+                }
+                report.wibErrors += (status[i] & status_wib_error) != 0;
+                report.unknownVersions += (status[i] & status_unknown_version) != 0;
+                report.crcFailures += (status[i] & status_crc) != 0;
+                if(status[i] & status_failure_mask) {
+                    report.badFrames++;
+                    if(report.firstBad < 0)
+                        report.firstBad = first+i;
+                    report.lastBad = first+i;
+                }
+            }
+        }
+
+        // Add the counts of one chunk to those of its file.
+        void merge(FileReport& report, const FileReport& chunk) {
+            report.badFrames += chunk.badFrames;
+            report.crcFailures += chunk.crcFailures;
+            report.checksumAFailures += chunk.checksumAFailures;
+            report.checksumBFailures += chunk.checksumBFailures;
+            report.wibErrors += chunk.wibErrors;
+            report.s1Errors += chunk.s1Errors;
+            report.s2Errors += chunk.s2Errors;
+            report.unknownVersions += chunk.unknownVersions;
+            if(chunk.firstBad >= 0 && (report.firstBad < 0 || chunk.firstBad < report.firstBad))
+                report.firstBad = chunk.firstBad;
+            report.lastBad = std::max(report.lastBad, chunk.lastBad);
+        }
+
+        class CheckQueue {
+        private:
+            const std::vector<std::string>& _filenames;
+            std::vector<FileReport>& _reports;
+            const CheckOptions& _options;
+            const size_t _chunkFrames;
+            std::atomic<size_t> _nextFile;
+            std::mutex _mutex; // Guards the chunks, and the counts and flagged frames of the reports.
+            std::deque<Chunk> _chunks;
+            std::vector<std::vector<Flagged> > _flagged; // Only kept for verbose checks.
+
+            bool popChunk(Chunk& chunk) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if(_chunks.empty())
+                    return false;
+                chunk = _chunks.front();
+                _chunks.pop_front();
+                return true;
+            }
+
+            // Without keepStatus the status words only live in the worker's buffer until they are counted, so
+            // no file costs memory per frame.
+            void verify(const Chunk& chunk, std::vector<Frame>& buffer, std::vector<uint32_t>& statusBuffer) {
+                FileReport& report = _reports[chunk.index];
+                uint32_t* status;
+                if(_options.keepStatus) {
+                    status = &report.status[chunk.first];
+                } else {
+                    statusBuffer.resize(chunk.count);
+                    status = statusBuffer.data();
+                }
+                const word_t* frames = chunk.file->frames(chunk.first, chunk.count, buffer);
+                if(frames)
+                    verify_frames(frames, chunk.count, status);
+                else
+                    // Count frames that could not be read as failing their CRC.
+                    std::fill_n(status, chunk.count, status_crc);
+
+                FileReport counts;
+                std::vector<Flagged> flagged;
+                summarise(status, chunk.count, chunk.first, counts, _options.verbose ? &flagged : nullptr);
+                std::lock_guard<std::mutex> lock(_mutex);
+                merge(report, counts);
+                _flagged[chunk.index].insert(_flagged[chunk.index].end(), flagged.begin(), flagged.end());
+            }
+
+            // Open a file and verify it. Anything beyond the first chunk is queued for the other workers.
+            void openFile(const size_t i, std::vector<Frame>& buffer, std::vector<uint32_t>& statusBuffer) {
+                FileReport& report = _reports[i];
+                std::shared_ptr<FrameFile> file(new FrameFile);
+                if(!file->open(_filenames[i]))
+                    return;
+                if(file->trailing_bytes())
+                    return;
+                report.readable = true;
+                report.frames = file->size();
+                if(_options.keepStatus)
+                    report.status.resize(file->size());
+                if(!file->size())
+                    return;
+                file->adviseSequential();
+
+                const size_t first = std::min(_chunkFrames, file->size());
+                if(first < file->size()) {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    for(size_t f=first; f<file->size(); f+=_chunkFrames) {
+                        Chunk c = {file, i, f, std::min(_chunkFrames, file->size()-f)};
+                        _chunks.push_back(c);
+                    }
+                }
+                Chunk c = {file, i, 0, first};
+                verify(c, buffer, statusBuffer);
+            }
+
+        public:
+            CheckQueue(const std::vector<std::string>& filenames, std::vector<FileReport>& reports,
+                       const CheckOptions& options)
+                : _filenames(filenames), _reports(reports), _options(options),
+                  _chunkFrames(std::max<size_t>(options.chunkFrames, 1)), _nextFile(0), _flagged(filenames.size()) {}
+
+            // Queued chunks go first so that the files currently open are finished (and closed) early.
+            void work() {
+                std::vector<Frame> buffer;
+                std::vector<uint32_t> statusBuffer;
+                Chunk chunk;
+                while(true) {
+                    if(popChunk(chunk)) {
+                        verify(chunk, buffer, statusBuffer);
+                        continue;
+                    }
+                    const size_t i = _nextFile++;
+                    if(i >= _filenames.size())
+                        return;
+                    openFile(i, buffer, statusBuffer);
+                }
+            }
+
+            // Frames of file i with findings, in file order. Only valid once all workers are done.
+            std::vector<Flagged>& flagged(const size_t i) {
+                std::sort(_flagged[i].begin(), _flagged[i].end());
+                return _flagged[i];
+            }
+        };
+
+        // A file of one frame is named like the frame files of check(), any other frame as in checkSingleFile().
+        void printReport(const FileReport& report, const std::vector<Flagged>& flagged) {
+            for(size_t i=0; i<flagged.size(); i++)
+                printStatus(flagged[i].second, report.frames == 1
+                            ? report.filename : std::to_string(flagged[i].first) + " of file " + report.filename);
+        }
+
+        std::string escape(const std::string& s) {
+            std::string out;
+            for(size_t i=0; i<s.size(); i++) {
+                const char c = s[i];
+                if(c == '"' || c == '\\') {
+                    out += '\\';
+                    out += c;
+                } else if((unsigned char)c < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else
+                    out += c;
+            }
+            return out;
+        }
+    } // namespace
+
+    bool printStatus(const uint32_t status, const std::string& name) {
+        if(status & status_unknown_version)
+            std::cout << "Warning: frame " << name << " has an unknown version; checked as " << DefaultFormat::name()
+                << "." << std::endl;
+        // Check checksums.
+        for(int i=0; i<4; i++) {
+            if(status & (status_checksum_a<<i))
+                std::cout << "Frame " << name << ", COLDATA block " << i+1 << "/4 contains an error in checksum A." << std::endl;
+            if(status & (status_checksum_b<<i))
+                std::cout << "Frame " << name << ", COLDATA block " << i+1 << "/4 contains an error in checksum B." << std::endl;
+        }
+        if(status & status_crc) {
+            std::cout << "Frame " << name << " failed its cyclic redundancy check." << std::endl;
+            return false;
+        }
+
+        // Check errors and produce a warning.
+        if(status & status_wib_error) // WIB_Errors
+            std::cout << "Warning: WIB error bit set in frame " << name << "." << std::endl;
+        for(int i=0; i<4; i++){
+            if(status & (status_s1_error<<i)) // Stream errors
+                std::cout << "Warning: S1 error bit set in frame " << name << ", block " << i+1 << "/4." << std::endl;
+            if(status & (status_s2_error<<i)) // Stream errors
+                std::cout << "Warning: S2 error bit set in frame " << name << ", block " << i+1 << "/4." << std::endl;
+        }
+        return true;
+    }
+
+    //=============
+    // CheckReport
+    //=============
+    bool CheckReport::ok() const {
+        for(size_t i=0; i<files.size(); i++)
+            if(!files[i].ok())
+                return false;
+        return true;
+    }
+
+    uint64_t CheckReport::frames() const {
+        uint64_t n = 0;
+        for(size_t i=0; i<files.size(); i++)
+            n += files[i].frames;
+        return n;
+    }
+
+    uint64_t CheckReport::badFrames() const {
+        uint64_t n = 0;
+        for(size_t i=0; i<files.size(); i++)
+            n += files[i].badFrames;
+        return n;
+    }
+
+    uint64_t CheckReport::crcFailures() const {
+        uint64_t n = 0;
+        for(size_t i=0; i<files.size(); i++)
+            n += files[i].crcFailures;
+        return n;
+    }
+
+    std::string CheckReport::json(const bool withStatus) const {
+        std::ostringstream out;
+        out << "{\n  \"ok\": " << (ok() ? "true" : "false")
+            << ",\n  \"seconds\": " << seconds
+            << ",\n  \"frames\": " << frames()
+            << ",\n  \"bad_frames\": " << badFrames()
+            << ",\n  \"crc_failures\": " << crcFailures()
+            << ",\n  \"files\": [";
+        for(size_t i=0; i<files.size(); i++) {
+            const FileReport& f = files[i];
+            out << (i ? ",\n" : "\n")
+                << "    {\"filename\": \"" << escape(f.filename) << "\""
+                << ", \"readable\": " << (f.readable ? "true" : "false")
+                << ", \"frames\": " << f.frames
+                << ", \"bad_frames\": " << f.badFrames
+                << ", \"crc_failures\": " << f.crcFailures
+                << ", \"checksum_a_failures\": " << f.checksumAFailures
+                << ", \"checksum_b_failures\": " << f.checksumBFailures
+                << ", \"wib_errors\": " << f.wibErrors
+                << ", \"s1_errors\": " << f.s1Errors
+                << ", \"s2_errors\": " << f.s2Errors
+                << ", \"unknown_versions\": " << f.unknownVersions
+                << ", \"first_bad\": " << f.firstBad
+                << ", \"last_bad\": " << f.lastBad;
+            if(withStatus) {
+                out << ", \"status\": [";
+                for(size_t j=0; j<f.status.size(); j++)
+                    out << (j ? "," : "") << f.status[j];
+                out << "]";
+            }
+            out << "}";
+        }
+        out << (files.empty() ? "]\n}\n" : "\n  ]\n}\n");
+        return out.str();
+    }
+
+    bool CheckReport::writeJSON(const std::string& filename, const bool withStatus) const {
+        std::ofstream ofile(filename);
+        if(!ofile) {
+            std::cout << "Error (CheckReport::writeJSON()): file " << filename << " could not be opened." << std::endl;
+            return false;
+        }
+        ofile << json(withStatus);
+        return (bool)ofile;
+    }
+
+    //==========
+    // Checkers
+    //==========
+    CheckReport checkFiles(const std::vector<std::string>& filenames, const CheckOptions& options) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        CheckReport report;
+        report.files.resize(filenames.size());
+        for(size_t i=0; i<filenames.size(); i++)
+            report.files[i].filename = filenames[i];
+
+        unsigned threads = options.threads ? options.threads : std::thread::hardware_concurrency();
+        threads = std::max(1u, threads);
+
+        CheckQueue queue(filenames, report.files, options);
+        std::vector<std::thread> workers;
+        for(unsigned t=1; t<threads; t++)
+            workers.push_back(std::thread(&CheckQueue::work, &queue));
+        queue.work();
+        for(size_t t=0; t<workers.size(); t++)
+            workers[t].join();
+
+        for(size_t i=0; i<report.files.size(); i++) {
+            FileReport& file = report.files[i];
+            if(!file.readable && options.verbose)
+                std::cout << "Error: file " << file.filename << " could not be opened or contains unreadable frames." << std::endl;
+            if(options.verbose)
+                printReport(file, queue.flagged(i));
+        }
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return report;
+    }
+
+    CheckReport checkFile(const std::string& filename, const CheckOptions& options) {
+        return checkFiles(std::vector<std::string>(1, filename), options);
+    }
+
+} // namespace framegen
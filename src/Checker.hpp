@@ -0,0 +1,79 @@
+//==========================================================================
+// Name        : Checker.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Parallel frame file verification with structured reports.
+//============================================================================
+
+#ifndef FRAMEGEN_CHECKER_HPP_
+#define FRAMEGEN_CHECKER_HPP_
+
+#include <string>
+#include <vector>
+
+#include "Types.hpp"
+
+namespace framegen {
+
+// Results for a single file. Counts of checksum failures and error bits are
+// per block, so one frame can contribute up to four to each.
+struct FileReport {
+  std::string filename;
+  bool readable = false;  // Opened and made up of whole frames.
+  uint64_t frames = 0;
+  uint64_t badFrames = 0;  // Frames failing a checksum or their CRC.
+  uint64_t crcFailures = 0;
+  uint64_t checksumAFailures = 0;
+  uint64_t checksumBFailures = 0;
+  uint64_t wibErrors = 0;
+  uint64_t s1Errors = 0;
+  uint64_t s2Errors = 0;
+  uint64_t unknownVersions = 0;  // Frames checked with the default layout.
+  int64_t firstBad = -1;  // Index of the first/last bad frame, -1 if none.
+  int64_t lastBad = -1;
+  std::vector<uint32_t> status;  // Per-frame status bits (see Verify.hpp).
+
+  // Same criterion as the console checkers: readable and no CRC failures.
+  bool ok() const { return readable && crcFailures == 0; }
+};
+
+struct CheckReport {
+  std::vector<FileReport> files;
+  double seconds = 0;
+
+  bool ok() const;
+  uint64_t frames() const;
+  uint64_t badFrames() const;
+  uint64_t crcFailures() const;
+
+  // JSON export. Per-frame status words are only included on request.
+  std::string json(bool withStatus = false) const;
+  bool writeJSON(const std::string& filename, bool withStatus = false) const;
+};
+
+struct CheckOptions {
+  unsigned threads = 0;          // Zero: one thread per hardware core.
+  bool verbose = false;          // Print findings to std::cout.
+  // Keep the per-frame status words. Without them a check needs no memory
+  // per frame; the counts are the same.
+  bool keepStatus = true;
+  size_t chunkFrames = 1 << 14;  // Frames per work item within a file.
+};
+
+// Verify every frame of the given files. Files are spread across worker
+// threads and large files are additionally split into chunks, so a single
+// capture is verified in parallel as well. Unlike the old checkers this
+// does not stop at the first CRC failure.
+CheckReport checkFiles(const std::vector<std::string>& filenames,
+                       const CheckOptions& options = CheckOptions());
+CheckReport checkFile(const std::string& filename,
+                      const CheckOptions& options = CheckOptions());
+
+// Print the findings in a frame's verification status in the checkers' usual
+// wording. Returns false if the frame failed its CRC.
+bool printStatus(uint32_t status, const std::string& name);
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_CHECKER_HPP_ */
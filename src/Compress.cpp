@@ -0,0 +1,381 @@
+//============================================================================
+// Name        : Compress.cpp
+// Author      : Milo Vermeulen, FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2017, 2026 Milo Vermeulen and FrameGen contributors
+// Description : Streaming chunked compression of frame files.
+//============================================================================
+
+#include "src/Compress.hpp"
+#include "src/CRC32.hpp"
+#include "src/FrameGen.hpp"
+#include "src/Metrics.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "zlib.h"
+
+namespace framegen {
+
+    namespace {
+        inline void put16(uint8_t* p, uint16_t v) { p[0] = v; p[1] = v>>8; }
+        inline void put32(uint8_t* p, uint32_t v) { put16(p, v); put16(p+2, v>>16); }
+        inline void put64(uint8_t* p, uint64_t v) { put32(p, v); put32(p+4, v>>32); }
+        inline uint16_t get16(const uint8_t* p) { return (uint16_t)(p[0] | p[1]<<8); }
+        inline uint32_t get32(const uint8_t* p) { return get16(p) | (uint32_t)get16(p+2)<<16; }
+        inline uint64_t get64(const uint8_t* p) { return get32(p) | (uint64_t)get32(p+4)<<32; }
+
+        const size_t chunk_header_bytes = 8;
+        // Window for streaming through legacy files.
+        const size_t legacy_window = 1 << 20;
+
+        // Owns an inflate stream and ends it on scope exit.
+        class Inflater {
+        private:
+            bool _ok;
+        public:
+            z_stream s;
+
+            Inflater() {
+                memset(&s, 0, sizeof(s));
+                _ok = inflateInit(&s) == Z_OK;
+            }
+            ~Inflater() {
+                if(_ok)
+                    inflateEnd(&s);
+            }
+            bool ok() const { return _ok; }
+        };
+
+        bool readFully(std::istream& in, uint8_t* p, size_t n) {
+            in.read(reinterpret_cast<char*>(p), n);
+            return (size_t)in.gcount() == n;
+        }
+
+        // Chunk sizes, followed by the CRC of the raw data if the header asks for it.
+        bool writeChunk(std::ostream& out, const ContainerHeader& header, const uint8_t* raw, uint32_t rawSize,
+                        const uint8_t* payload, uint32_t compSize) {
+            uint8_t head[chunk_header_bytes+4];
+            put32(head, rawSize);
+            put32(head+4, compSize);
+            put32(head+8, zcrc32(0, raw, rawSize));
+            out.write(reinterpret_cast<const char*>(head), chunk_header_bytes + (header.flags & ContainerHeader::flag_chunk_crc? 4: 0));
+            out.write(reinterpret_cast<const char*>(payload), compSize);
+            return (bool)out;
+        }
+
+        // Index entries followed by the trailer that locates them from the end of the file.
+        bool writeIndex(std::ostream& out, const std::vector<ChunkIndexEntry>& index, uint64_t offset) {
+            std::vector<uint8_t> buf(index.size()*ChunkIndexEntry::size + ChunkIndexEntry::trailer_size);
+            for(size_t i=0; i<index.size(); i++)
+                index[i].serialize(&buf[i*ChunkIndexEntry::size]);
+            uint8_t* trailer = &buf[index.size()*ChunkIndexEntry::size];
+            put64(trailer, offset);
+            put32(trailer+8, index.size());
+            put32(trailer+12, ChunkIndexEntry::trailer_magic);
+            out.write(reinterpret_cast<const char*>(buf.data()), buf.size());
+            return (bool)out;
+        }
+
+        // Upper bound on the payload of a chunk, used to reject corrupt sizes before allocating. Allows for backends
+        // that expand incompressible data, as the WIB codec does to about twice its size.
+        size_t maxPayload(const ContainerHeader& header) {
+            return std::max<size_t>(compressBound(header.chunkBytes), 3*(size_t)header.chunkBytes) + 4096;
+        }
+
+        bool decompressLegacy(std::istream& in, std::ostream& out, const uint8_t* head, size_t headBytes) {
+            Inflater z;
+            if(!z.ok()) {
+                std::cout << "Error (decompress()): out of memory." << std::endl;
+                return false;
+            }
+            std::vector<uint8_t> ibuf(legacy_window), obuf(legacy_window);
+            memcpy(ibuf.data(), head, headBytes);
+            size_t have = headBytes;
+            int ret = Z_OK;
+            while(ret != Z_STREAM_END) {
+                if(!have) {
+                    in.read(reinterpret_cast<char*>(ibuf.data()), ibuf.size());
+                    have = in.gcount();
+                    if(!have) {
+                        std::cout << "Error (decompress()): the data was truncated." << std::endl;
+                        return false;
+                    }
+                }
+                z.s.next_in = ibuf.data();
+                z.s.avail_in = have;
+                do {
+                    z.s.next_out = obuf.data();
+                    z.s.avail_out = obuf.size();
+                    ret = inflate(&z.s, Z_NO_FLUSH);
+                    if(ret != Z_OK && ret != Z_STREAM_END) {
+                        std::cout << "Error (decompress()): the data was corrupted." << std::endl;
+                        return false;
+                    }
+                    out.write(reinterpret_cast<const char*>(obuf.data()), obuf.size()-z.s.avail_out);
+                } while(z.s.avail_out == 0 && ret != Z_STREAM_END);
+                have = 0;
+            }
+            return (bool)out;
+        }
+    } // namespace
+
+    //=================
+    // ContainerHeader
+    //=================
+    void ContainerHeader::serialize(uint8_t out[size]) const {
+        put32(out, magic);
+        put16(out+4, version);
+        out[6] = (uint8_t)codec;
+        out[7] = (uint8_t)level;
+        put32(out+8, chunkBytes);
+        put32(out+12, flags);
+        put64(out+16, originalSize);
+        put64(out+24, frameCount);
+    }
+
+    bool ContainerHeader::deserialize(const uint8_t in[size]) {
+        if(get32(in) != magic)
+            return false;
+        version = get16(in+4);
+        codec = (Codec)in[6];
+        level = (int8_t)in[7];
+        chunkBytes = get32(in+8);
+        flags = get32(in+12);
+        originalSize = get64(in+16);
+        frameCount = get64(in+24);
+        return true;
+    }
+
+    //=================
+    // ChunkIndexEntry
+    //=================
+    void ChunkIndexEntry::setTimestamps(const uint8_t* raw, const size_t rawSize) {
+        minTimestamp = UINT64_MAX;
+        maxTimestamp = 0;
+        for(size_t pos=0; pos+num_frame_bytes<=rawSize; pos+=num_frame_bytes) {
+            const uint64_t timestamp = ConstFrameView(reinterpret_cast<const word_t*>(raw+pos)).timestamp();
+            minTimestamp = std::min(minTimestamp, timestamp);
+            maxTimestamp = std::max(maxTimestamp, timestamp);
+        }
+    }
+
+    void ChunkIndexEntry::serialize(uint8_t out[size]) const {
+        put64(out, offset);
+        put64(out+8, firstFrame);
+        put64(out+16, minTimestamp);
+        put64(out+24, maxTimestamp);
+    }
+
+    void ChunkIndexEntry::deserialize(const uint8_t in[size]) {
+        offset = get64(in);
+        firstFrame = get64(in+8);
+        minTimestamp = get64(in+16);
+        maxTimestamp = get64(in+24);
+    }
+
+    //===============
+    // Compression
+    //===============
+    bool compressStream(std::istream& in, std::ostream& out, const unsigned long long length, const CompressOptions& options,
+                        CompressorStats* stats) {
+        std::unique_ptr<Compressor> compressor = options.compressor.empty()
+            ? makeCompressor(options.codec, options.level) : makeCompressor(options.compressor, options.level);
+        if(!compressor)
+            return false;
+        const bool ok = compressStream(in, out, length, *compressor, options.chunkFrames);
+        if(stats)
+            *stats = compressor->compressStats();
+        return ok;
+    }
+
+    bool compressStream(std::istream& in, std::ostream& out, const unsigned long long length, Compressor& compressor,
+                        const uint32_t chunkFrames) {
+        ContainerHeader header;
+        header.codec = compressor.codec();
+        header.level = compressor.level();
+        if(chunkFrames > ContainerHeader::max_chunk_bytes / num_frame_bytes) {
+            std::cout << "Error (compress()): chunks of " << chunkFrames << " frames exceed the limit of "
+                << ContainerHeader::max_chunk_bytes / num_frame_bytes << "." << std::endl;
+            return false;
+        }
+        header.chunkBytes = std::max<uint32_t>(chunkFrames, 1) * num_frame_bytes;
+        header.originalSize = length;
+        header.frameCount = length / num_frame_bytes;
+
+        uint8_t head[ContainerHeader::size];
+        header.serialize(head);
+        out.write(reinterpret_cast<const char*>(head), sizeof(head));
+
+        std::vector<uint8_t> ibuf(header.chunkBytes), obuf;
+        obuf.reserve(compressBound(header.chunkBytes));
+        // Offsets are counted rather than asked from the stream, which need not be seekable.
+        const size_t chunkHeaderBytes = chunk_header_bytes + (header.flags & ContainerHeader::flag_chunk_crc? 4: 0);
+        std::vector<ChunkIndexEntry> index;
+        uint64_t offset = sizeof(head), frame = 0;
+
+        unsigned long long left = length;
+        while(left) {
+            const uint32_t rawSize = std::min<unsigned long long>(left, header.chunkBytes);
+            if(!readFully(in, ibuf.data(), rawSize)) {
+                std::cout << "Error (compress()): could not read the input." << std::endl;
+                return false;
+            }
+            left -= rawSize;
+
+            obuf.clear();
+            bool compressed;
+            {
+                FRAMEGEN_METRICS_SCOPE(metric_compress, rawSize / num_frame_bytes, rawSize);
+                compressed = compressor.compress(ibuf.data(), rawSize, obuf);
+            }
+            if(!compressed || obuf.size() > maxPayload(header)) {
+                std::cout << "Error (compress()): " << compressor.name() << " could not compress a chunk." << std::endl;
+                return false;
+            }
+            if(!writeChunk(out, header, ibuf.data(), rawSize, obuf.data(), obuf.size()))
+                break;
+
+            ChunkIndexEntry entry;
+            entry.offset = offset;
+            entry.firstFrame = frame;
+            entry.setTimestamps(ibuf.data(), rawSize);
+            index.push_back(entry);
+            offset += chunkHeaderBytes + obuf.size();
+            frame += rawSize / num_frame_bytes;
+        }
+
+        // End marker.
+        const uint8_t end[chunk_header_bytes] = {0};
+        out.write(reinterpret_cast<const char*>(end), sizeof(end));
+        if(header.flags & ContainerHeader::flag_index)
+            writeIndex(out, index, offset + sizeof(end));
+        if(!out) {
+            std::cout << "Error (compress()): could not write the output." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    //=================
+    // Decompression
+    //=================
+    bool decompressStream(std::istream& in, std::ostream& out, CompressorStats* stats) {
+        uint8_t head[ContainerHeader::size];
+        in.read(reinterpret_cast<char*>(head), sizeof(head));
+        const size_t headBytes = in.gcount();
+
+        ContainerHeader header;
+        if(headBytes < sizeof(head) || !header.deserialize(head))
+            return decompressLegacy(in, out, head, headBytes);
+
+        if(header.version > ContainerHeader::current_version) {
+            std::cout << "Error (decompress()): unsupported container version " << header.version << "." << std::endl;
+            return false;
+        }
+        CompressorInfo info;
+        if(!findCompressor(header.codec, info)) {
+            std::cout << "Error (decompress()): unsupported codec " << (unsigned)header.codec << "." << std::endl;
+            return false;
+        }
+        if(!header.validChunkBytes()) {
+            std::cout << "Error (decompress()): invalid chunk size " << header.chunkBytes << "." << std::endl;
+            return false;
+        }
+        std::unique_ptr<Compressor> compressor = makeCompressor(header.codec, header.level);
+        std::vector<uint8_t> ibuf(maxPayload(header)), obuf(header.chunkBytes);
+
+        const bool hasCRC = header.flags & ContainerHeader::flag_chunk_crc;
+        unsigned long long total = 0;
+        while(true) {
+            uint8_t chunk[chunk_header_bytes+4];
+            if(!readFully(in, chunk, chunk_header_bytes)) {
+                std::cout << "Error (decompress()): the data was truncated." << std::endl;
+                return false;
+            }
+            const uint32_t rawSize = get32(chunk), compSize = get32(chunk+4);
+            if(!rawSize && !compSize)
+                break;
+            if(rawSize > header.chunkBytes || compSize > ibuf.size() || (hasCRC && !readFully(in, chunk+8, 4))
+               || !readFully(in, ibuf.data(), compSize)) {
+                std::cout << "Error (decompress()): the data was corrupted." << std::endl;
+                return false;
+            }
+
+            if(!compressor->decompress(ibuf.data(), compSize, obuf.data(), rawSize)
+               || (hasCRC && zcrc32(0, obuf.data(), rawSize) != get32(chunk+8))) {
+                std::cout << "Error (decompress()): the data was corrupted." << std::endl;
+                return false;
+            }
+            out.write(reinterpret_cast<const char*>(obuf.data()), rawSize);
+            total += rawSize;
+        }
+
+        if(stats)
+            *stats = compressor->decompressStats();
+        if(total != header.originalSize) {
+            std::cout << "Error (decompress()): expected " << header.originalSize << " bytes but found " << total << "." << std::endl;
+            return false;
+        }
+        return (bool)out;
+    }
+
+    bool readContainerHeader(const std::string& filename, ContainerHeader& header) {
+        std::ifstream in(filename, std::ios::binary);
+        uint8_t head[ContainerHeader::size];
+        return readFully(in, head, sizeof(head)) && header.deserialize(head);
+    }
+
+    //=============
+    // File level
+    //=============
+    bool compressFile(const std::string& input, const std::string& output, const CompressOptions& options,
+                      CompressorStats* stats) {
+        std::ifstream in(input, std::ios::binary);
+        if(!in) {
+            std::cout << "Error (compress()): file " << input << " could not be opened." << std::endl;
+            return false;
+        }
+        in.seekg(0, in.end);
+        const unsigned long long length = in.tellg();
+        in.seekg(0, in.beg);
+
+        std::ofstream out(output, std::ios::binary);
+        if(!out) {
+            std::cout << "Error (compress()): file " << output << " could not be created." << std::endl;
+            return false;
+        }
+        bool ok = compressStream(in, out, length, options, stats);
+        out.close();
+        ok = ok && !out.fail();
+        if(!ok)
+            remove(output.c_str());
+        return ok;
+    }
+
+    bool decompressFile(const std::string& input, const std::string& output, CompressorStats* stats) {
+        std::ifstream in(input, std::ios::binary);
+        if(!in) {
+            std::cout << "Error (decompress()): file " << input << " could not be opened." << std::endl;
+            return false;
+        }
+        std::ofstream out(output, std::ios::binary);
+        if(!out) {
+            std::cout << "Error (decompress()): file " << output << " could not be created." << std::endl;
+            return false;
+        }
+        bool ok = decompressStream(in, out, stats);
+        out.close();
+        ok = ok && !out.fail();
+        if(!ok)
+            remove(output.c_str());
+        return ok;
+    }
+
+} // namespace framegen
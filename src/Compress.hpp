@@ -0,0 +1,121 @@
+//==========================================================================
+// Name        : Compress.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Streaming chunked compression of frame files.
+//============================================================================
+
+#ifndef FRAMEGEN_COMPRESS_HPP_
+#define FRAMEGEN_COMPRESS_HPP_
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+#include "Compressor.hpp"
+#include "Types.hpp"
+
+namespace framegen {
+
+// ==================================================================
+// Container layout, all integers little-endian:
+//   header (32 bytes): magic "FGZC", version, codec, level, chunk size,
+//                      flags, original size, frame count
+//   chunks:            raw size (4), compressed size (4), zlib CRC-32 of
+//                      the raw data (4, only with flag_chunk_crc), payload
+//   end marker:        both sizes zero
+//   index (flag_index): per chunk its offset from the start of the header,
+//                      first frame number and lowest and highest frame
+//                      timestamp (8 bytes each), then the offset of the
+//                      index (8), the number of entries (4) and "FGZI"
+// Every chunk is compressed independently from at most chunkBytes of input,
+// so compression and decompression need a fixed amount of memory. Chunks are
+// coded by the Compressor registered for the codec id.
+// ==================================================================
+struct ContainerHeader {
+  static const uint32_t magic = 0x435A4746;  // "FGZC" in file order.
+  static const uint16_t current_version = 1;
+  static const size_t size = 32;
+  static const uint32_t flag_chunk_crc = 1 << 0;
+  static const uint32_t flag_index = 1 << 1;
+  // Readers allocate a chunk's worth of memory up front, so larger chunks are
+  // refused.
+  static const uint32_t max_chunk_bytes = 64 << 20;
+
+  uint16_t version = current_version;
+  Codec codec = Codec::zlib;
+  int8_t level = 6;
+  uint32_t chunkBytes = 0;
+  uint32_t flags = flag_chunk_crc | flag_index;
+  uint64_t originalSize = 0;
+  uint64_t frameCount = 0;
+
+  void serialize(uint8_t out[size]) const;
+  // False if the bytes do not start with the container magic.
+  bool deserialize(const uint8_t in[size]);
+  // Whole frames, and no more than max_chunk_bytes.
+  bool validChunkBytes() const {
+    return chunkBytes && chunkBytes <= max_chunk_bytes &&
+           chunkBytes % num_frame_bytes == 0;
+  }
+};
+
+// One entry of the seek index. Timestamps are the extremes over the whole
+// frames in the chunk, so corrupted timestamps widen the range rather than
+// hide frames; a chunk without whole frames has minTimestamp > maxTimestamp.
+struct ChunkIndexEntry {
+  static const size_t size = 32;
+  static const uint32_t trailer_magic = 0x495A4746;  // "FGZI" in file order.
+  static const size_t trailer_size = 16;
+
+  uint64_t offset = 0;
+  uint64_t firstFrame = 0;
+  uint64_t minTimestamp = 0;
+  uint64_t maxTimestamp = 0;
+
+  // Set the timestamps from the raw contents of the chunk.
+  void setTimestamps(const uint8_t* raw, size_t rawSize);
+  bool contains(uint64_t timestamp) const {
+    return minTimestamp <= timestamp && timestamp <= maxTimestamp;
+  }
+
+  void serialize(uint8_t out[size]) const;
+  void deserialize(const uint8_t in[size]);
+};
+
+struct CompressOptions {
+  std::string compressor;  // Registered backend name; overrides codec.
+  Codec codec = Codec::zlib;
+  int level = use_default_level;  // Backend-specific, clamped to its range.
+  uint32_t chunkFrames = 4096;    // Input per chunk, in whole frames.
+                                  // Together at most max_chunk_bytes.
+};
+
+// Compress a stream of the given length into a container.
+bool compressStream(std::istream& in, std::ostream& out,
+                    unsigned long long length,
+                    const CompressOptions& options = CompressOptions(),
+                    CompressorStats* stats = nullptr);
+// Same with a caller-owned compressor, which keeps its statistics.
+bool compressStream(std::istream& in, std::ostream& out,
+                    unsigned long long length, Compressor& compressor,
+                    uint32_t chunkFrames = 4096);
+// Decompress a container, or a plain zlib stream as written by older
+// versions of compressFile(). Statistics are only kept for containers.
+bool decompressStream(std::istream& in, std::ostream& out,
+                      CompressorStats* stats = nullptr);
+
+// Read just the header of a compressed file. False for legacy files.
+bool readContainerHeader(const std::string& filename, ContainerHeader& header);
+
+// File-to-file variants. The input is left in place.
+bool compressFile(const std::string& input, const std::string& output,
+                  const CompressOptions& options = CompressOptions(),
+                  CompressorStats* stats = nullptr);
+bool decompressFile(const std::string& input, const std::string& output,
+                    CompressorStats* stats = nullptr);
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_COMPRESS_HPP_ */
@@ -0,0 +1,259 @@
+//============================================================================
+// Name        : CompressedFile.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Random access to frames in a compressed container.
+//============================================================================
+
+#include "src/CompressedFile.hpp"
+#include "src/CRC32.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace framegen {
+
+    namespace {
+        inline uint32_t get32(const uint8_t* p) { return p[0] | p[1]<<8 | p[2]<<16 | (uint32_t)p[3]<<24; }
+        inline uint64_t get64(const uint8_t* p) { return get32(p) | (uint64_t)get32(p+4)<<32; }
+
+        const CompressorStats no_stats = CompressorStats();
+    } // namespace
+
+    bool CompressedFile::open(const std::string& filename) {
+        close();
+        _filename = filename;
+        _in.open(filename, std::ios::binary);
+        if(!_in) {
+            std::cout << "Error (CompressedFile::open()): file " << filename << " could not be opened." << std::endl;
+            return false;
+        }
+        _in.seekg(0, std::ios::end);
+        _bytes = _in.tellg();
+        _in.seekg(0, std::ios::beg);
+
+        uint8_t head[ContainerHeader::size];
+        _in.read(reinterpret_cast<char*>(head), sizeof(head));
+        if((size_t)_in.gcount() != sizeof(head) || !_header.deserialize(head)) {
+            std::cout << "Error (CompressedFile::open()): " << filename << " is not a frame container." << std::endl;
+            close();
+            return false;
+        }
+        CompressorInfo info;
+        if(_header.version > ContainerHeader::current_version || !findCompressor(_header.codec, info)
+           || !_header.validChunkBytes()) {
+            std::cout << "Error (CompressedFile::open()): " << filename << " uses an unsupported format." << std::endl;
+            close();
+            return false;
+        }
+        _compressor = makeCompressor(_header.codec, _header.level);
+        _chunk.resize(_header.chunkBytes);
+
+        // Fall back to scanning when the index is missing or does not fit the file.
+        if(!((_header.flags & ContainerHeader::flag_index) && readIndex()) && !scanIndex()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void CompressedFile::close() {
+        if(_in.is_open())
+            _in.close();
+        _in.clear();
+        _bytes = 0;
+        _header = ContainerHeader();
+        _index.clear();
+        _compressor.reset();
+        _cached = npos;
+        _chunkFrames = 0;
+    }
+
+    bool CompressedFile::readIndex() {
+        uint8_t trailer[ChunkIndexEntry::trailer_size];
+        if(_bytes < ContainerHeader::size + sizeof(trailer))
+            return false;
+        _in.seekg(_bytes - sizeof(trailer));
+        if(!_in.read(reinterpret_cast<char*>(trailer), sizeof(trailer))
+           || get32(trailer+12) != ChunkIndexEntry::trailer_magic) {
+            _in.clear();
+            return false;
+        }
+        const uint64_t offset = get64(trailer);
+        const uint32_t count = get32(trailer+8);
+        const uint64_t expected = (_header.originalSize + _header.chunkBytes - 1) / _header.chunkBytes;
+        if(count != expected || offset + (uint64_t)count*ChunkIndexEntry::size + sizeof(trailer) != _bytes)
+            return false;
+
+        std::vector<uint8_t> buf((size_t)count*ChunkIndexEntry::size);
+        _in.seekg(offset);
+        if(!_in.read(reinterpret_cast<char*>(buf.data()), buf.size())) {
+            _in.clear();
+            return false;
+        }
+        // Chunks hold a fixed number of frames and follow each other, so every entry can be checked; the index has
+        // no checksum of its own.
+        const uint64_t chunkFrames = _header.chunkBytes / num_frame_bytes;
+        _index.resize(count);
+        for(size_t c=0; c<count; c++) {
+            _index[c].deserialize(&buf[c*ChunkIndexEntry::size]);
+            const uint64_t previous = c ? _index[c-1].offset : ContainerHeader::size - 1;
+            if(_index[c].firstFrame != c*chunkFrames || _index[c].offset <= previous || _index[c].offset >= offset) {
+                _index.clear();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool CompressedFile::scanIndex() {
+        _index.clear();
+        uint64_t offset = ContainerHeader::size, frame = 0;
+        while(true) {
+            uint8_t sizes[8];
+            _in.seekg(offset);
+            if(!_in.read(reinterpret_cast<char*>(sizes), sizeof(sizes))) {
+                std::cout << "Error (CompressedFile::open()): the data was truncated." << std::endl;
+                return false;
+            }
+            if(!get32(sizes) && !get32(sizes+4))
+                break;
+            if(!decompressAt(offset))
+                return false;
+            ChunkIndexEntry entry;
+            entry.offset = offset;
+            entry.firstFrame = frame;
+            entry.setTimestamps(_chunk.data(), get32(sizes));
+            _index.push_back(entry);
+            offset += 8 + (_header.flags & ContainerHeader::flag_chunk_crc? 4: 0) + get32(sizes+4);
+            frame += get32(sizes) / num_frame_bytes;
+        }
+        return true;
+    }
+
+    bool CompressedFile::decompressAt(const uint64_t offset) {
+        uint8_t head[12];
+        const size_t headBytes = 8 + (_header.flags & ContainerHeader::flag_chunk_crc? 4: 0);
+        _in.seekg(offset);
+        if(!_in.read(reinterpret_cast<char*>(head), headBytes)) {
+            _in.clear();
+            std::cout << "Error (CompressedFile): the data was truncated." << std::endl;
+            return false;
+        }
+        const uint32_t rawSize = get32(head), compSize = get32(head+4);
+        if(rawSize > _header.chunkBytes || offset + headBytes + compSize > _bytes) {
+            std::cout << "Error (CompressedFile): the data was corrupted." << std::endl;
+            return false;
+        }
+        _payload.resize(compSize);
+        if(!_in.read(reinterpret_cast<char*>(_payload.data()), compSize)) {
+            _in.clear();
+            std::cout << "Error (CompressedFile): the data was truncated." << std::endl;
+            return false;
+        }
+        _cached = npos;
+        _chunkFrames = 0;
+        if(!_compressor->decompress(_payload.data(), compSize, _chunk.data(), rawSize)
+           || (headBytes > 8 && zcrc32(0, _chunk.data(), rawSize) != get32(head+8))) {
+            std::cout << "Error (CompressedFile): the data was corrupted." << std::endl;
+            return false;
+        }
+        _chunkFrames = rawSize / num_frame_bytes;
+        return true;
+    }
+
+    bool CompressedFile::load(const size_t chunk) {
+        if(chunk == _cached)
+            return true;
+        if(chunk >= _index.size()) {
+            std::cout << "Error (CompressedFile): the data was corrupted." << std::endl;
+            return false;
+        }
+        if(!decompressAt(_index[chunk].offset))
+            return false;
+        _cached = chunk;
+        return true;
+    }
+
+    size_t CompressedFile::chunkOf(const size_t i) const {
+        if(i >= size())
+            return npos;
+        // The last chunk whose first frame is not beyond i.
+        std::vector<ChunkIndexEntry>::const_iterator it = std::upper_bound(_index.begin(), _index.end(), (uint64_t)i,
+            [](uint64_t frame, const ChunkIndexEntry& entry) { return frame < entry.firstFrame; });
+        return it == _index.begin() ? npos : it - _index.begin() - 1;
+    }
+
+    bool CompressedFile::readFrame(const size_t i, Frame& out) {
+        const size_t chunk = chunkOf(i);
+        if(chunk == npos) {
+            std::cout << "Error (CompressedFile::readFrame()): frame " << i << " is out of range." << std::endl;
+            return false;
+        }
+        if(!load(chunk))
+            return false;
+        if(i - _index[chunk].firstFrame >= _chunkFrames) {
+            std::cout << "Error (CompressedFile::readFrame()): the data was corrupted." << std::endl;
+            return false;
+        }
+        memcpy(out.data(), &_chunk[(i - _index[chunk].firstFrame)*num_frame_bytes], num_frame_bytes);
+        return true;
+    }
+
+    bool CompressedFile::readFrames(const size_t first, const size_t count, std::vector<Frame>& out) {
+        if(first > size() || count > size() - first) {
+            std::cout << "Error (CompressedFile::readFrames()): frames " << first << " to " << first+count
+                << " are out of range." << std::endl;
+            return false;
+        }
+        const size_t start = out.size();
+        out.resize(start + count);
+        for(size_t i=first; i<first+count; ) {
+            const size_t chunk = chunkOf(i);
+            if(!load(chunk)) {
+                out.resize(start);
+                return false;
+            }
+            const size_t inChunk = i - _index[chunk].firstFrame;
+            if(inChunk >= _chunkFrames) {
+                std::cout << "Error (CompressedFile::readFrames()): the data was corrupted." << std::endl;
+                out.resize(start);
+                return false;
+            }
+            const size_t n = std::min<size_t>(first+count - i, _chunkFrames - inChunk);
+            memcpy(out[start + i-first].data(), &_chunk[inChunk*num_frame_bytes], n*num_frame_bytes);
+            i += n;
+        }
+        return true;
+    }
+
+    bool CompressedFile::readRange(const uint64_t t0, const uint64_t t1, std::vector<Frame>& out) {
+        if(t0 >= t1)
+            return true;
+        for(size_t c=0; c<_index.size(); c++) {
+            const ChunkIndexEntry& entry = _index[c];
+            if(entry.maxTimestamp < t0 || entry.minTimestamp >= t1)
+                continue;
+            if(!load(c))
+                return false;
+            const size_t last = c+1 < _index.size() ? _index[c+1].firstFrame : size();
+            const size_t n = last > entry.firstFrame ? std::min<size_t>(last - entry.firstFrame, _chunkFrames) : 0;
+            for(size_t i=0; i<n; i++) {
+                const uint8_t* frame = &_chunk[i*num_frame_bytes];
+                const uint64_t timestamp = ConstFrameView(reinterpret_cast<const word_t*>(frame)).timestamp();
+                if(timestamp < t0 || timestamp >= t1)
+                    continue;
+                out.push_back(Frame());
+                memcpy(out.back().data(), frame, num_frame_bytes);
+            }
+        }
+        return true;
+    }
+
+    const CompressorStats& CompressedFile::stats() const {
+        return _compressor ? _compressor->decompressStats() : no_stats;
+    }
+
+} // namespace framegen
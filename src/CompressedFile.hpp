@@ -0,0 +1,83 @@
+//==========================================================================
+// Name        : CompressedFile.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Random access to frames in a compressed container.
+//============================================================================
+
+#ifndef FRAMEGEN_COMPRESSEDFILE_HPP_
+#define FRAMEGEN_COMPRESSEDFILE_HPP_
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Compress.hpp"
+#include "FrameGen.hpp"
+
+namespace framegen {
+
+// ==================================================================
+// Reads single frames or time ranges from a container written by
+// compressStream(), decompressing only the chunks that hold them. The seek
+// index is read from the end of the file; containers without one are indexed
+// by decompressing every chunk once when opened. The most recently used chunk
+// is kept, so reading nearby frames in order is cheap. Not thread-safe; use
+// one instance per thread.
+// ==================================================================
+class CompressedFile {
+ private:
+  std::string _filename;
+  std::ifstream _in;
+  unsigned long long _bytes = 0;
+  ContainerHeader _header;
+  std::vector<ChunkIndexEntry> _index;
+  std::unique_ptr<Compressor> _compressor;
+
+  std::vector<uint8_t> _payload, _chunk;
+  size_t _cached = npos;
+  size_t _chunkFrames = 0;  // Complete frames in _chunk.
+
+  bool readIndex();
+  bool scanIndex();
+  // Decompress the chunk at offset into _chunk.
+  bool decompressAt(uint64_t offset);
+  bool load(size_t chunk);
+
+ public:
+  static const size_t npos = (size_t)-1;
+
+  CompressedFile() {}
+  explicit CompressedFile(const std::string& filename) { open(filename); }
+  CompressedFile(const CompressedFile&) = delete;
+  CompressedFile& operator=(const CompressedFile&) = delete;
+
+  bool open(const std::string& filename);
+  void close();
+
+  bool is_open() const { return _in.is_open(); }
+  const std::string& filename() const { return _filename; }
+  const ContainerHeader& header() const { return _header; }
+  const std::vector<ChunkIndexEntry>& index() const { return _index; }
+  // Number of complete frames.
+  size_t size() const { return _header.frameCount; }
+
+  // Chunk holding frame i, or npos if there is no such frame.
+  size_t chunkOf(size_t i) const;
+
+  // Copy frame i into out.
+  bool readFrame(size_t i, Frame& out);
+  // Append frames [first, first+count) to out.
+  bool readFrames(size_t first, size_t count, std::vector<Frame>& out);
+  // Append every frame with t0 <= timestamp < t1 to out, in file order.
+  bool readRange(uint64_t t0, uint64_t t1, std::vector<Frame>& out);
+
+  // Decompression totals of the chunks read so far.
+  const CompressorStats& stats() const;
+};
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_COMPRESSEDFILE_HPP_ */
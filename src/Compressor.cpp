@@ -0,0 +1,346 @@
+//============================================================================
+// Name        : Compressor.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Block compressor interface and backend registry.
+//============================================================================
+
+#include "src/Compressor.hpp"
+#include "src/WIBCodec.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+
+#include "zlib.h"
+#ifdef FRAMEGEN_HAVE_LZ4
+#include "lz4.h"
+#include "lz4hc.h"
+#endif
+#ifdef FRAMEGEN_HAVE_ZSTD
+#include "zstd.h"
+#endif
+
+namespace framegen {
+
+    namespace {
+        inline double elapsed(const std::chrono::steady_clock::time_point& start) {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        //=========
+        // Backends
+        //=========
+        class StoreCompressor : public Compressor {
+        protected:
+            bool compressBlock(const uint8_t* src, size_t n, std::vector<uint8_t>& dst) {
+                dst.insert(dst.end(), src, src+n);
+                return true;
+            }
+            bool decompressBlock(const uint8_t* src, size_t n, uint8_t* dst, size_t rawSize) {
+                if(n != rawSize)
+                    return false;
+                // An empty block may come with a null pointer.
+                if(n)
+                    memcpy(dst, src, n);
+                return true;
+            }
+        public:
+            explicit StoreCompressor(int level) : Compressor(level) {}
+            const char* name() const { return "store"; }
+            Codec codec() const { return Codec::store; }
+        };
+
+        // Every block is a complete zlib stream. The streams are reset rather than reinitialised between blocks.
+        class ZlibCompressor : public Compressor {
+        private:
+            z_stream _deflate, _inflate;
+            bool _deflateOK = false, _inflateOK = false;
+        protected:
+            bool compressBlock(const uint8_t* src, size_t n, std::vector<uint8_t>& dst) {
+                if(!_deflateOK) {
+                    memset(&_deflate, 0, sizeof(_deflate));
+                    if(deflateInit(&_deflate, _level) != Z_OK)
+                        return false;
+                    _deflateOK = true;
+                }
+                deflateReset(&_deflate);
+                const size_t offset = dst.size();
+                dst.resize(offset + compressBound(n));
+                _deflate.next_in = const_cast<Bytef*>(src);
+                _deflate.avail_in = n;
+                _deflate.next_out = dst.data() + offset;
+                _deflate.avail_out = dst.size() - offset;
+                const bool ok = deflate(&_deflate, Z_FINISH) == Z_STREAM_END;
+                dst.resize(offset + _deflate.total_out);
+                return ok;
+            }
+            bool decompressBlock(const uint8_t* src, size_t n, uint8_t* dst, size_t rawSize) {
+                if(!_inflateOK) {
+                    memset(&_inflate, 0, sizeof(_inflate));
+                    if(inflateInit(&_inflate) != Z_OK)
+                        return false;
+                    _inflateOK = true;
+                }
+                inflateReset(&_inflate);
+                _inflate.next_in = const_cast<Bytef*>(src);
+                _inflate.avail_in = n;
+                _inflate.next_out = dst;
+                _inflate.avail_out = rawSize;
+                return inflate(&_inflate, Z_FINISH) == Z_STREAM_END && _inflate.total_out == rawSize;
+            }
+        public:
+            explicit ZlibCompressor(int level) : Compressor(level) {}
+            ~ZlibCompressor() {
+                if(_deflateOK)
+                    deflateEnd(&_deflate);
+                if(_inflateOK)
+                    inflateEnd(&_inflate);
+            }
+            const char* name() const { return "zlib"; }
+            Codec codec() const { return Codec::zlib; }
+        };
+
+        class WIBCompressor : public Compressor {
+        protected:
+            bool compressBlock(const uint8_t* src, size_t n, std::vector<uint8_t>& dst) {
+                wib_compress(src, n, dst, _level);
+                return true;
+            }
+            bool decompressBlock(const uint8_t* src, size_t n, uint8_t* dst, size_t rawSize) {
+                return wib_decompress(src, n, dst, rawSize);
+            }
+        public:
+            explicit WIBCompressor(int level) : Compressor(level) {}
+            const char* name() const { return "wib"; }
+            Codec codec() const { return Codec::wib; }
+        };
+
+#ifdef FRAMEGEN_HAVE_LZ4
+        // Level 0 is the fast LZ4 compressor; higher levels use LZ4HC.
+        class LZ4Compressor : public Compressor {
+        protected:
+            bool compressBlock(const uint8_t* src, size_t n, std::vector<uint8_t>& dst) {
+                const size_t offset = dst.size();
+                dst.resize(offset + LZ4_compressBound(n));
+                char* out = reinterpret_cast<char*>(dst.data() + offset);
+                const int bound = dst.size() - offset;
+                const int written = _level > 0
+                    ? LZ4_compress_HC(reinterpret_cast<const char*>(src), out, n, bound, _level)
+                    : LZ4_compress_default(reinterpret_cast<const char*>(src), out, n, bound);
+                dst.resize(offset + std::max(written, 0));
+                return written > 0 || n == 0;
+            }
+            bool decompressBlock(const uint8_t* src, size_t n, uint8_t* dst, size_t rawSize) {
+                return LZ4_decompress_safe(reinterpret_cast<const char*>(src), reinterpret_cast<char*>(dst), n, rawSize)
+                    == (int)rawSize;
+            }
+        public:
+            explicit LZ4Compressor(int level) : Compressor(level) {}
+            const char* name() const { return "lz4"; }
+            Codec codec() const { return Codec::lz4; }
+        };
+#endif
+
+#ifdef FRAMEGEN_HAVE_ZSTD
+        class ZstdCompressor : public Compressor {
+        private:
+            ZSTD_CCtx* _cctx = nullptr;
+            ZSTD_DCtx* _dctx = nullptr;
+        protected:
+            bool compressBlock(const uint8_t* src, size_t n, std::vector<uint8_t>& dst) {
+                if(!_cctx && !(_cctx = ZSTD_createCCtx()))
+                    return false;
+                const size_t offset = dst.size();
+                dst.resize(offset + ZSTD_compressBound(n));
+                const size_t written = ZSTD_compressCCtx(_cctx, dst.data() + offset, dst.size() - offset, src, n, _level);
+                if(ZSTD_isError(written)) {
+                    dst.resize(offset);
+                    return false;
+                }
+                dst.resize(offset + written);
+                return true;
+            }
+            bool decompressBlock(const uint8_t* src, size_t n, uint8_t* dst, size_t rawSize) {
+                if(!_dctx && !(_dctx = ZSTD_createDCtx()))
+                    return false;
+                return ZSTD_decompressDCtx(_dctx, dst, rawSize, src, n) == rawSize;
+            }
+        public:
+            explicit ZstdCompressor(int level) : Compressor(level) {}
+            ~ZstdCompressor() {
+                ZSTD_freeCCtx(_cctx);
+                ZSTD_freeDCtx(_dctx);
+            }
+            const char* name() const { return "zstd"; }
+            Codec codec() const { return Codec::zstd; }
+        };
+#endif
+
+        template <class T>
+        CompressorInfo builtin(const char* name, Codec codec, int minLevel, int maxLevel, int defaultLevel) {
+            CompressorInfo info;
+            info.name = name;
+            info.codec = codec;
+            info.minLevel = minLevel;
+            info.maxLevel = maxLevel;
+            info.defaultLevel = defaultLevel;
+            info.factory = [](int level) { return std::unique_ptr<Compressor>(new T(level)); };
+            return info;
+        }
+
+        //==========
+        // Registry
+        //==========
+        struct Registry {
+            // Recursive, so that factories may look up other backends.
+            std::recursive_mutex mutex;
+            std::map<std::string, CompressorInfo> byName;
+
+            Registry() {
+                add(builtin<StoreCompressor>("store", Codec::store, 0, 0, 0));
+                add(builtin<ZlibCompressor>("zlib", Codec::zlib, 0, 9, 6));
+                add(builtin<WIBCompressor>("wib", Codec::wib, 0, 1, 1));
+#ifdef FRAMEGEN_HAVE_LZ4
+                add(builtin<LZ4Compressor>("lz4", Codec::lz4, 0, 12, 0));
+#endif
+#ifdef FRAMEGEN_HAVE_ZSTD
+                add(builtin<ZstdCompressor>("zstd", Codec::zstd, 1, ZSTD_maxCLevel(), 3));
+#endif
+            }
+
+            void add(const CompressorInfo& info) { byName[info.name] = info; }
+
+            const CompressorInfo* find(const std::string& name) {
+                std::map<std::string, CompressorInfo>::const_iterator it = byName.find(name);
+                return it == byName.end() ? nullptr : &it->second;
+            }
+
+            const CompressorInfo* find(const Codec codec) {
+                for(std::map<std::string, CompressorInfo>::const_iterator it=byName.begin(); it!=byName.end(); ++it)
+                    if(it->second.codec == codec)
+                        return &it->second;
+                return nullptr;
+            }
+        };
+
+        Registry& registry() {
+            static Registry r;
+            return r;
+        }
+
+        // Only with the registry locked.
+
+        std::unique_ptr<Compressor> make(const CompressorInfo* info, int level) {
+            if(!info)
+                return std::unique_ptr<Compressor>();
+            if(level == use_default_level)
+                level = info->defaultLevel;
+            return info->factory(std::max(info->minLevel, std::min(info->maxLevel, level)));
+        }
+    } // namespace
+
+    //============
+    // Compressor
+    //============
+    bool Compressor::compress(const uint8_t* src, size_t n, std::vector<uint8_t>& dst) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const size_t before = dst.size();
+        const bool ok = compressBlock(src, n, dst);
+        _compressStats.calls++;
+        _compressStats.bytesIn += n;
+        _compressStats.bytesOut += dst.size() - before;
+        _compressStats.seconds += elapsed(start);
+        return ok;
+    }
+
+    bool Compressor::decompress(const uint8_t* src, size_t n, uint8_t* dst, size_t rawSize) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const bool ok = decompressBlock(src, n, dst, rawSize);
+        // Counted the same way round as compression: bytesIn is the raw side.
+        _decompressStats.calls++;
+        _decompressStats.bytesIn += rawSize;
+        _decompressStats.bytesOut += n;
+        _decompressStats.seconds += elapsed(start);
+        return ok;
+    }
+
+    //==========
+    // Registry
+    //==========
+    bool registerCompressor(const CompressorInfo& info) {
+        Registry& r = registry();
+        std::lock_guard<std::recursive_mutex> lock(r.mutex);
+        const CompressorInfo* existing = r.find(info.codec);
+        if(existing && existing->name != info.name) {
+            std::cout << "Error (registerCompressor()): codec " << (unsigned)info.codec << " is already registered as "
+                << existing->name << "." << std::endl;
+            return false;
+        }
+        r.add(info);
+        return true;
+    }
+
+    bool findCompressor(const std::string& name, CompressorInfo& info) {
+        Registry& r = registry();
+        std::lock_guard<std::recursive_mutex> lock(r.mutex);
+        const CompressorInfo* found = r.find(name);
+        if(found)
+            info = *found;
+        return found;
+    }
+
+    bool findCompressor(const Codec codec, CompressorInfo& info) {
+        Registry& r = registry();
+        std::lock_guard<std::recursive_mutex> lock(r.mutex);
+        const CompressorInfo* found = r.find(codec);
+        if(found)
+            info = *found;
+        return found;
+    }
+
+    std::unique_ptr<Compressor> makeCompressor(const std::string& name, const int level) {
+        std::unique_ptr<Compressor> c;
+        {
+            Registry& r = registry();
+            std::lock_guard<std::recursive_mutex> lock(r.mutex);
+            c = make(r.find(name), level);
+        }
+        if(!c)
+            std::cout << "Error (makeCompressor()): no compressor named " << name << "." << std::endl;
+        return c;
+    }
+
+    std::unique_ptr<Compressor> makeCompressor(const Codec codec, const int level) {
+        std::unique_ptr<Compressor> c;
+        {
+            Registry& r = registry();
+            std::lock_guard<std::recursive_mutex> lock(r.mutex);
+            c = make(r.find(codec), level);
+        }
+        if(!c)
+            std::cout << "Error (makeCompressor()): no compressor for codec " << (unsigned)codec << "." << std::endl;
+        return c;
+    }
+
+    std::vector<CompressorInfo> compressors() {
+        Registry& r = registry();
+        std::lock_guard<std::recursive_mutex> lock(r.mutex);
+        std::vector<CompressorInfo> list;
+        for(std::map<std::string, CompressorInfo>::const_iterator it=r.byName.begin(); it!=r.byName.end(); ++it)
+            list.push_back(it->second);
+        return list;
+    }
+
+    std::string codecName(const Codec codec) {
+        Registry& r = registry();
+        std::lock_guard<std::recursive_mutex> lock(r.mutex);
+        const CompressorInfo* info = r.find(codec);
+        return info ? info->name : "unknown";
+    }
+
+} // namespace framegen
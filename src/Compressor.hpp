@@ -0,0 +1,114 @@
+//==========================================================================
+// Name        : Compressor.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Block compressor interface and backend registry.
+//============================================================================
+
+#ifndef FRAMEGEN_COMPRESSOR_HPP_
+#define FRAMEGEN_COMPRESSOR_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Types.hpp"
+
+namespace framegen {
+
+// Codec identifiers as stored in the container header. Never renumber.
+enum class Codec : uint8_t {
+  store = 0,  // Raw bytes.
+  zlib = 1,   // Deflate over the raw bytes.
+  wib = 2,    // ADC prediction and rANS, see WIBCodec.hpp.
+  lz4 = 3,    // Only when built with LZ4.
+  zstd = 4,   // Only when built with Zstandard.
+};
+
+// Totals over all calls in one direction.
+struct CompressorStats {
+  uint64_t calls = 0;
+  uint64_t bytesIn = 0;
+  uint64_t bytesOut = 0;
+  double seconds = 0;
+
+  double ratio() const { return bytesOut ? (double)bytesIn / bytesOut : 0; }
+  double MBps() const { return seconds > 0 ? bytesIn / seconds / 1e6 : 0; }
+};
+
+// ==================================================================
+// A compression backend working on independent blocks. Instances keep their
+// working state between calls and are not thread-safe; use one per thread.
+// ==================================================================
+class Compressor {
+ private:
+  CompressorStats _compressStats, _decompressStats;
+
+ protected:
+  int _level;
+
+  virtual bool compressBlock(const uint8_t* src, size_t n,
+                             std::vector<uint8_t>& dst) = 0;
+  virtual bool decompressBlock(const uint8_t* src, size_t n, uint8_t* dst,
+                               size_t rawSize) = 0;
+
+ public:
+  explicit Compressor(int level) : _level(level) {}
+  virtual ~Compressor() {}
+
+  virtual const char* name() const = 0;
+  virtual Codec codec() const = 0;
+  int level() const { return _level; }
+
+  // Append the compressed form of n bytes to dst.
+  bool compress(const uint8_t* src, size_t n, std::vector<uint8_t>& dst);
+  // Decompress exactly rawSize bytes into dst.
+  bool decompress(const uint8_t* src, size_t n, uint8_t* dst, size_t rawSize);
+
+  const CompressorStats& compressStats() const { return _compressStats; }
+  const CompressorStats& decompressStats() const { return _decompressStats; }
+  void resetStats() {
+    _compressStats = CompressorStats();
+    _decompressStats = CompressorStats();
+  }
+};
+
+// ==================================================================
+// Registry. Backends are known by name and by codec id; the built-in ones
+// (store, zlib, wib, and lz4/zstd when available) are always registered.
+// ==================================================================
+typedef std::function<std::unique_ptr<Compressor>(int level)>
+    CompressorFactory;
+
+struct CompressorInfo {
+  std::string name;
+  Codec codec;
+  int minLevel, maxLevel, defaultLevel;
+  CompressorFactory factory;
+};
+
+// Add or replace a backend. Returns false if the codec id is taken by a
+// backend with a different name. Factories run with the registry locked, so a
+// backend cannot be replaced while it is being made.
+bool registerCompressor(const CompressorInfo& info);
+// Out-of-range levels are clamped; use_default_level picks the default.
+static const int use_default_level = -1000;
+std::unique_ptr<Compressor> makeCompressor(const std::string& name,
+                                           int level = use_default_level);
+std::unique_ptr<Compressor> makeCompressor(Codec codec,
+                                           int level = use_default_level);
+// Copy the backend registered under the name or codec into info; false if
+// there is none.
+bool findCompressor(const std::string& name, CompressorInfo& info);
+bool findCompressor(Codec codec, CompressorInfo& info);
+std::vector<CompressorInfo> compressors();
+
+// "unknown" if no backend has the codec.
+std::string codecName(Codec codec);
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_COMPRESSOR_HPP_ */
@@ -0,0 +1,64 @@
+//==========================================================================
+// Name        : Cpu.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Runtime CPU feature detection for the SIMD kernels.
+//============================================================================
+
+#ifndef FRAMEGEN_CPU_HPP_
+#define FRAMEGEN_CPU_HPP_
+
+// SIMD kernels are compiled per function with target attributes, so the
+// library itself does not need to be built with -march flags. Which kernel
+// runs is decided once at runtime with the functions below.
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define FRAMEGEN_X86 1
+#define FRAMEGEN_TARGET(isa) __attribute__((target(isa)))
+#include <immintrin.h>
+#else
+#define FRAMEGEN_TARGET(isa)
+#endif
+
+// Plain loops that should be vectorised for more than one ISA are written
+// once as an always-inlined body and wrapped in one function per target.
+#if defined(__GNUC__) || defined(__clang__)
+#define FRAMEGEN_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define FRAMEGEN_ALWAYS_INLINE inline
+#endif
+
+namespace framegen {
+namespace cpu {
+
+#ifdef FRAMEGEN_X86
+inline bool supports_sse41() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("sse4.1");
+}
+inline bool supports_avx2() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+}
+inline bool supports_pclmul() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+}
+#else
+inline bool supports_sse41() { return false; }
+inline bool supports_avx2() { return false; }
+inline bool supports_pclmul() { return false; }
+#endif
+
+// Spin-wait hint: eases the pressure of a busy loop on its sibling hyperthread.
+inline void relax() {
+#ifdef FRAMEGEN_X86
+  __builtin_ia32_pause();
+#endif
+}
+
+}  // namespace cpu
+}  // namespace framegen
+
+#endif /* FRAMEGEN_CPU_HPP_ */
@@ -0,0 +1,156 @@
+//============================================================================
+// Name        : Emitter.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Emission of frames at a fixed rate against the clock.
+//============================================================================
+
+#include "src/Emitter.hpp"
+#include "src/Cpu.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace framegen {
+
+    namespace {
+        typedef std::chrono::steady_clock Clock;
+
+        void waitUntil(const Clock::time_point deadline, const EmitterOptions& options) {
+            if(options.wait == WaitMode::sleep) {
+                std::this_thread::sleep_until(deadline);
+                return;
+            }
+            if(options.wait == WaitMode::hybrid && deadline - Clock::now() > options.spinWindow)
+                std::this_thread::sleep_until(deadline - options.spinWindow);
+            while(Clock::now() < deadline)
+                cpu::relax();
+        }
+
+        // New timestamp, and the CRC over it. The COLDATA checksums only cover the ADC words.
+        inline void restamp(Frame& frame, const uint64_t timestamp) {
+            frame.set_timestamp(timestamp);
+            frame.set_CRC32(frame.calculate_zCRC32());
+        }
+    } // namespace
+
+    //===================
+    // LatenessHistogram
+    //===================
+    void LatenessHistogram::add(const uint64_t ns) {
+        unsigned b = 0;
+        while(b+1 < num_buckets && ns >= (1ull << b))
+            b++;
+        buckets[b]++;
+        count++;
+        max = std::max(max, ns);
+        sum += ns;
+    }
+
+    uint64_t LatenessHistogram::percentile(const double fraction) const {
+        const double target = fraction*count;
+        uint64_t seen = 0;
+        for(unsigned b=0; b<num_buckets; b++) {
+            seen += buckets[b];
+            if(seen && seen >= target)
+                return std::min<uint64_t>(1ull << b, max);
+        }
+        return max;
+    }
+
+    std::string EmitterStats::json() const {
+        std::ostringstream out;
+        out << "{\n  \"frames\": " << frames
+            << ",\n  \"batches\": " << batches
+            << ",\n  \"missed\": " << missed
+            << ",\n  \"dropped\": " << dropped
+            << ",\n  \"seconds\": " << seconds
+            << ",\n  \"rate\": " << rate()
+            << ",\n  \"lateness_ns\": {\"mean\": " << lateness.mean()
+            << ", \"p50\": " << lateness.percentile(0.5)
+            << ", \"p99\": " << lateness.percentile(0.99)
+            << ", \"p999\": " << lateness.percentile(0.999)
+            << ", \"max\": " << lateness.max
+            << ", \"buckets\": [";
+        unsigned last = 0;
+        for(unsigned b=0; b<LatenessHistogram::num_buckets; b++)
+            if(lateness.buckets[b])
+                last = b;
+        for(unsigned b=0; b<=last; b++)
+            out << (b ? "," : "") << lateness.buckets[b];
+        out << "]}\n}\n";
+        return out.str();
+    }
+
+    //=========
+    // Emitter
+    //=========
+    bool Emitter::run(const uint64_t Nframes, const Sink& sink) {
+        _stats = EmitterStats();
+        _stop = false;
+        if(!(_options.rate > 0)) {
+            std::cout << "Error (Emitter::run()): the rate must be positive." << std::endl;
+            return false;
+        }
+        const unsigned batchFrames = std::max(1u, _options.batchFrames);
+        const std::chrono::duration<double, std::nano> period(1e9*batchFrames/_options.rate);
+        const std::chrono::nanoseconds tolerance = _options.tolerance.count() > 0
+            ? _options.tolerance : std::chrono::duration_cast<std::chrono::nanoseconds>(period);
+
+        // Everything that can be prepared is prepared before the clock starts.
+        std::vector<Frame> pool, batch;
+        if(_options.poolFrames)
+            _generator.generateBuffer(pool, std::max<size_t>(_options.poolFrames, batchFrames));
+        else
+            _generator.generateBuffer(batch, batchFrames);
+        batch.resize(batchFrames);
+
+        bool ok = true;
+        uint64_t next = 0; // Frames sent or dropped so far.
+        const Clock::time_point start = Clock::now();
+        for(uint64_t k=0; !_stop && (!Nframes || next < Nframes); k++) {
+            const unsigned long count = Nframes ? std::min<uint64_t>(batchFrames, Nframes-next) : batchFrames;
+            const Clock::time_point deadline
+                = start + std::chrono::duration_cast<Clock::duration>(period*(double)k);
+            if(_options.dropLate && Clock::now() - deadline > period) {
+                _generator.clock().claim(count);
+                _stats.dropped += count;
+                next += count;
+                continue;
+            }
+
+            // Every batch claims its timestamps from the generator's clock, so they stay unique among the
+            // generators sharing it. Generated batches already have theirs; replayed ones are restamped.
+            if(pool.empty()) {
+                if(k > 0)
+                    _generator.generateBuffer(batch, batchFrames);
+            } else {
+                const uint64_t firstTimestamp = _generator.clock().claim(count);
+                for(unsigned long i=0; i<count; i++) {
+                    batch[i] = pool[(next+i) % pool.size()];
+                    restamp(batch[i], firstTimestamp + frame_timestamp_step*i);
+                }
+            }
+
+            waitUntil(deadline, _options);
+            const Clock::duration late = Clock::now() - deadline;
+            const uint64_t lateness = std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(late).count());
+            _stats.lateness.add(lateness);
+            if(late > tolerance)
+                _stats.missed++;
+            if(!sink(batch.data(), count)) {
+                ok = false;
+                break;
+            }
+            _stats.frames += count;
+            _stats.batches++;
+            next += count;
+        }
+        _stats.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return ok;
+    }
+
+} // namespace framegen
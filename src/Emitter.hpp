@@ -0,0 +1,112 @@
+//==========================================================================
+// Name        : Emitter.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Emission of frames at a fixed rate against the clock.
+//============================================================================
+
+#ifndef FRAMEGEN_EMITTER_HPP_
+#define FRAMEGEN_EMITTER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "FrameGen.hpp"
+
+namespace framegen {
+
+// How the emitter waits for the next deadline.
+enum class WaitMode {
+  busy,    // Spin on the clock. Most precise; uses a whole core.
+  hybrid,  // Sleep until close to the deadline, then spin.
+  sleep,   // Sleep until the deadline. Precision is up to the scheduler.
+};
+
+struct EmitterOptions {
+  double rate = nominal_frame_rate;  // Frames per second.
+  unsigned batchFrames = 1;          // Frames handed to the sink at once.
+  WaitMode wait = WaitMode::hybrid;
+  // Hybrid mode stops sleeping this long before a deadline.
+  std::chrono::nanoseconds spinWindow = std::chrono::microseconds(50);
+  // A batch sent later than this after its deadline counts as missed. Zero
+  // means one batch period.
+  std::chrono::nanoseconds tolerance = std::chrono::nanoseconds(0);
+  // Drop batches whose deadline passed more than a period ago instead of
+  // sending them in a burst to catch up. Their timestamps are skipped, as if
+  // the link had lost them.
+  bool dropLate = false;
+  // Frames generated up front and replayed with new timestamps and CRCs.
+  // Zero generates every batch as it is due, which caps the rate at what
+  // FrameGen can fill.
+  size_t poolFrames = 1 << 16;
+};
+
+// Lateness in powers of two of nanoseconds: bucket b counts latenesses below
+// 2^b ns (and at least 2^(b-1) ns for b > 0).
+struct LatenessHistogram {
+  static const unsigned num_buckets = 64;
+  uint64_t buckets[num_buckets] = {};
+  uint64_t count = 0;
+  uint64_t max = 0;
+  double sum = 0;
+
+  void add(uint64_t ns);
+  double mean() const { return count ? sum / count : 0; }
+  // Upper bound of the bucket holding the given fraction (0-1) of samples.
+  uint64_t percentile(double fraction) const;
+};
+
+struct EmitterStats {
+  uint64_t frames = 0;   // Frames handed to the sink.
+  uint64_t batches = 0;
+  uint64_t missed = 0;   // Batches sent later than the tolerance.
+  uint64_t dropped = 0;  // Frames dropped with dropLate.
+  double seconds = 0;
+  LatenessHistogram lateness;
+
+  double rate() const { return seconds > 0 ? frames / seconds : 0; }
+  std::string json() const;
+};
+
+// ==================================================================
+// Sends frames from a FrameGen to a sink at a fixed rate, measured against
+// the steady clock from the start of run(). Batch k is due k*batchFrames/rate
+// after the start; the emitter waits for each deadline, hands the batch to
+// the sink and records how late it was. Every batch claims its timestamps
+// from the generator's clock, so they stay unique when other generators share
+// it; within a batch they are frame_timestamp_step apart whatever the rate,
+// as a faster link would.
+// ==================================================================
+class Emitter {
+ private:
+  FrameGen& _generator;
+  EmitterOptions _options;
+  EmitterStats _stats;
+  std::atomic<bool> _stop;
+
+ public:
+  typedef std::function<bool(const Frame*, unsigned long)> Sink;
+
+  explicit Emitter(FrameGen& generator,
+                   const EmitterOptions& options = EmitterOptions())
+      : _generator(generator), _options(options), _stop(false) {}
+
+  void setOptions(const EmitterOptions& options) { _options = options; }
+  const EmitterOptions& options() const { return _options; }
+
+  // Emit Nframes frames, or until stop() if Nframes is zero. Stops early if
+  // the sink returns false.
+  bool run(uint64_t Nframes, const Sink& sink);
+  // Ask a running emitter to return. Safe to call from any thread.
+  void stop() { _stop = true; }
+
+  const EmitterStats& stats() const { return _stats; }
+};
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_EMITTER_HPP_ */
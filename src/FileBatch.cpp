@@ -0,0 +1,566 @@
+//============================================================================
+// Name        : FileBatch.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Asynchronous creation of many small files.
+//============================================================================
+
+#include "src/FileBatch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FRAMEGEN_POSIX 1
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef FRAMEGEN_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace framegen {
+
+    class FileBatchWriter::Backend {
+    public:
+        virtual ~Backend() {}
+        virtual const char* name() const = 0;
+        // Takes a copy of the name and data.
+        virtual bool write(const std::string& filename, const void* data, size_t bytes) = 0;
+        // Waits for all queued files; returns the number that failed since the last call and describes the first.
+        virtual uint64_t finish(std::string& firstError) = 0;
+    };
+
+    namespace {
+        std::string describe(const std::string& filename, const int err) {
+            return filename + ": " + strerror(err);
+        }
+
+        //===============
+        // Thread pool
+        //===============
+        class ThreadBackend : public FileBatchWriter::Backend {
+        private:
+            struct Job {
+                std::string filename;
+                std::vector<char> data;
+            };
+
+            const size_t _depth;
+            std::mutex _mutex;
+            std::condition_variable _queued, _done;
+            std::deque<Job> _jobs;
+            unsigned _busy = 0;
+            bool _stop = false;
+            uint64_t _failed = 0;
+            std::string _firstError;
+            std::vector<std::thread> _workers;
+
+            // Returns 0 or an errno value.
+            static int writeFile(const Job& job) {
+#ifdef FRAMEGEN_POSIX
+                const int fd = ::open(job.filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+                if(fd < 0)
+                    return errno;
+                size_t done = 0;
+                while(done < job.data.size()) {
+                    const ssize_t n = ::write(fd, job.data.data()+done, job.data.size()-done);
+                    if(n < 0 && errno == EINTR)
+                        continue;
+                    if(n <= 0) {
+                        const int err = n < 0 ? errno : EIO;
+                        ::close(fd);
+                        return err;
+                    }
+                    done += n;
+                }
+                return ::close(fd) ? errno : 0;
+#else
+                std::ofstream file(job.filename, std::ios::binary | std::ios::trunc);
+                file.write(job.data.data(), job.data.size());
+                file.close();
+                return file ? 0 : EIO;
+#endif
+            }
+
+            void work() {
+                std::unique_lock<std::mutex> lock(_mutex);
+                for(;;) {
+                    _queued.wait(lock, [this] { return _stop || !_jobs.empty(); });
+                    if(_jobs.empty())
+                        return;
+                    Job job = std::move(_jobs.front());
+                    _jobs.pop_front();
+                    _busy++;
+                    lock.unlock();
+                    const int err = writeFile(job);
+                    lock.lock();
+                    _busy--;
+                    if(err && !_failed++)
+                        _firstError = describe(job.filename, err);
+                    _done.notify_all();
+                }
+            }
+
+        public:
+            ThreadBackend(const unsigned threads, const size_t depth) : _depth(std::max<size_t>(depth, 1)) {
+                for(unsigned t=0; t<std::max(threads, 1u); t++)
+                    _workers.push_back(std::thread(&ThreadBackend::work, this));
+            }
+
+            ~ThreadBackend() {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _stop = true;
+                }
+                _queued.notify_all();
+                for(size_t t=0; t<_workers.size(); t++)
+                    _workers[t].join();
+            }
+
+            const char* name() const { return "threads"; }
+
+            bool write(const std::string& filename, const void* data, const size_t bytes) {
+                Job job;
+                job.filename = filename;
+                job.data.assign(static_cast<const char*>(data), static_cast<const char*>(data)+bytes);
+                std::unique_lock<std::mutex> lock(_mutex);
+                _done.wait(lock, [this] { return _jobs.size()+_busy < _depth; });
+                _jobs.push_back(std::move(job));
+                lock.unlock();
+                _queued.notify_one();
+                return true;
+            }
+
+            uint64_t finish(std::string& firstError) {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _done.wait(lock, [this] { return _jobs.empty() && !_busy; });
+                const uint64_t failed = _failed;
+                firstError = _firstError;
+                _failed = 0;
+                _firstError.clear();
+                return failed;
+            }
+        };
+
+#ifdef FRAMEGEN_HAVE_IO_URING
+        //===============
+        // io_uring
+        //===============
+        // Talks to the kernel directly rather than through liburing, which is rarely installed. Every file takes a
+        // slot: its open is queued with those of other files, and when it completes the write and close are queued
+        // as a linked pair. Submitting and reaping share one io_uring_enter() call whenever write() has to wait.
+        // If the ring stops accepting work, every file still in it is counted as failed and the remaining files go
+        // through a thread pool instead.
+        class IoUringBackend : public FileBatchWriter::Backend {
+        private:
+            enum Op { op_open = 0, op_write = 1, op_close = 2 };
+
+            struct Slot {
+                std::string filename;
+                std::vector<char> data;
+                int fd;
+                int err;
+            };
+
+            int _ring = -1;
+            void* _sqMap = MAP_FAILED;
+            void* _cqMap = MAP_FAILED;
+            size_t _sqMapBytes = 0, _cqMapBytes = 0;
+            io_uring_sqe* _sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+            size_t _sqesBytes = 0;
+
+            // Shared ring indices.
+            unsigned *_sqHead, *_sqTail, *_sqMask, *_sqArray;
+            unsigned *_cqHead, *_cqTail, *_cqMask;
+            io_uring_cqe* _cqes;
+            unsigned _sqEntries = 0;
+
+            unsigned _tail = 0;     // Local submission tail, published by submit().
+            unsigned _pending = 0;  // Queued but not yet submitted.
+
+            std::vector<Slot> _slots;
+            std::vector<unsigned> _free;
+            uint64_t _failed = 0;
+            std::string _firstError;
+
+            int _broken = 0;  // errno that made the ring unusable.
+            const unsigned _threads;
+            std::unique_ptr<ThreadBackend> _fallback;
+
+            static int enter(int ring, unsigned submit, unsigned wait, unsigned flags) {
+                return (int)syscall(__NR_io_uring_enter, ring, submit, wait, flags, nullptr, 0);
+            }
+
+            bool map(const unsigned entries) {
+                io_uring_params p;
+                memset(&p, 0, sizeof(p));
+                _ring = (int)syscall(__NR_io_uring_setup, entries, &p);
+                if(_ring < 0)
+                    return false;
+                _sqMapBytes = p.sq_off.array + p.sq_entries*sizeof(unsigned);
+                _cqMapBytes = p.cq_off.cqes + p.cq_entries*sizeof(io_uring_cqe);
+                if(p.features & IORING_FEAT_SINGLE_MMAP)
+                    _sqMapBytes = _cqMapBytes = std::max(_sqMapBytes, _cqMapBytes);
+                _sqMap = mmap(nullptr, _sqMapBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring,
+                              IORING_OFF_SQ_RING);
+                if(_sqMap == MAP_FAILED)
+                    return false;
+                if(p.features & IORING_FEAT_SINGLE_MMAP) {
+                    _cqMap = _sqMap;
+                } else {
+                    _cqMap = mmap(nullptr, _cqMapBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring,
+                                  IORING_OFF_CQ_RING);
+                    if(_cqMap == MAP_FAILED)
+                        return false;
+                }
+                _sqesBytes = p.sq_entries*sizeof(io_uring_sqe);
+                _sqes = static_cast<io_uring_sqe*>(mmap(nullptr, _sqesBytes, PROT_READ | PROT_WRITE,
+                                                        MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQES));
+                if(_sqes == MAP_FAILED)
+                    return false;
+
+                char* sq = static_cast<char*>(_sqMap);
+                char* cq = static_cast<char*>(_cqMap);
+                _sqHead = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+                _sqTail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+                _sqMask = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+                _sqArray = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+                _cqHead = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+                _cqTail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+                _cqMask = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+                _cqes = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+                _sqEntries = p.sq_entries;
+                _tail = *_sqTail;
+                return true;
+            }
+
+            // Opening, writing and closing through the ring need kernel 5.6 or later.
+            bool supported() {
+                const unsigned Nops = 256;
+                std::vector<char> buffer(sizeof(io_uring_probe) + Nops*sizeof(io_uring_probe_op), 0);
+                io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+                if(syscall(__NR_io_uring_register, _ring, IORING_REGISTER_PROBE, probe, Nops) < 0)
+                    return false;
+                const unsigned ops[] = {IORING_OP_OPENAT, IORING_OP_WRITE, IORING_OP_CLOSE};
+                for(unsigned i=0; i<3; i++)
+                    if(ops[i] > probe->last_op || !(probe->ops[ops[i]].flags & IO_URING_OP_SUPPORTED))
+                        return false;
+                return true;
+            }
+
+            void submit(const unsigned wait) {
+                __atomic_store_n(_sqTail, _tail, __ATOMIC_RELEASE);
+                for(;;) {
+                    const int n = enter(_ring, _pending, wait, wait ? IORING_ENTER_GETEVENTS : 0);
+                    if(n >= 0) {
+                        _pending -= std::min<unsigned>(n, _pending);
+                        return;
+                    }
+                    if(errno == EINTR)
+                        continue;
+                    // The completion queue is full; make room and try again.
+                    if(errno == EBUSY || errno == EAGAIN) {
+                        reap();
+                        if(_broken)
+                            return;
+                        continue;
+                    }
+                    abandon(errno);
+                    return;
+                }
+            }
+
+            // Gives up on the ring: files still in it are reported with err and their slots freed. Closes the
+            // kernel never took are done here, as are those of files whose open completes after this.
+            void abandon(const int err) {
+                if(_broken)
+                    return;
+                _broken = err;
+                drain();
+                for(unsigned i=_tail-_pending; i!=_tail; i++) {
+                    const io_uring_sqe& sqe = _sqes[_sqArray[i & *_sqMask]];
+                    if(sqe.opcode == IORING_OP_CLOSE)
+                        ::close(sqe.fd);
+                }
+                _pending = 0;
+                std::vector<bool> isFree(_slots.size(), false);
+                for(size_t i=0; i<_free.size(); i++)
+                    isFree[_free[i]] = true;
+                for(unsigned s=0; s<_slots.size(); s++) {
+                    if(isFree[s])
+                        continue;
+                    if(!_slots[s].err)
+                        _slots[s].err = err;
+                    release(s);
+                }
+            }
+
+            unsigned space() const { return _sqEntries - (_tail - __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE)); }
+
+            // Makes room for n submission queue entries; abandons the ring if the kernel will not take the queued
+            // ones.
+            bool reserve(const unsigned n) {
+                if(!_broken && space() < n)
+                    submit(0);
+                if(!_broken && space() < n)
+                    abandon(EBUSY);
+                return !_broken;
+            }
+
+            // Only call after reserve().
+            io_uring_sqe* next() {
+                const unsigned index = _tail & *_sqMask;
+                io_uring_sqe* sqe = &_sqes[index];
+                memset(sqe, 0, sizeof(*sqe));
+                _sqArray[index] = index;
+                _tail++;
+                _pending++;
+                return sqe;
+            }
+
+            // A failed reserve() has already released the slot.
+            void queueOpen(const unsigned s) {
+                if(!reserve(1))
+                    return;
+                io_uring_sqe* sqe = next();
+                sqe->opcode = IORING_OP_OPENAT;
+                sqe->fd = AT_FDCWD;
+                sqe->addr = reinterpret_cast<uint64_t>(_slots[s].filename.c_str());
+                sqe->len = 0644;
+                sqe->open_flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+                sqe->user_data = (uint64_t)s << 2 | op_open;
+            }
+
+            void queueWriteClose(const unsigned s) {
+                if(!reserve(2)) {
+                    ::close(_slots[s].fd);
+                    return;
+                }
+                io_uring_sqe* sqe = next();
+                sqe->opcode = IORING_OP_WRITE;
+                sqe->fd = _slots[s].fd;
+                sqe->addr = reinterpret_cast<uint64_t>(_slots[s].data.data());
+                sqe->len = _slots[s].data.size();
+                sqe->flags = IOSQE_IO_LINK;
+                sqe->user_data = (uint64_t)s << 2 | op_write;
+                sqe = next();
+                sqe->opcode = IORING_OP_CLOSE;
+                sqe->fd = _slots[s].fd;
+                sqe->user_data = (uint64_t)s << 2 | op_close;
+            }
+
+            void release(const unsigned s) {
+                if(_slots[s].err && !_failed++)
+                    _firstError = describe(_slots[s].filename, _slots[s].err);
+                _free.push_back(s);
+            }
+
+            void complete(const io_uring_cqe& cqe) {
+                const unsigned s = cqe.user_data >> 2;
+                Slot& slot = _slots[s];
+                switch(cqe.user_data & 3) {
+                case op_open:
+                    if(cqe.res < 0) {
+                        slot.err = -cqe.res;
+                        release(s);
+                    } else {
+                        slot.fd = cqe.res;
+                        queueWriteClose(s);
+                    }
+                    break;
+                case op_write:
+                    if(cqe.res != (int)slot.data.size() && !slot.err)
+                        slot.err = cqe.res < 0 ? -cqe.res : EIO;
+                    break;
+                case op_close:
+                    // A failed or short write cancels the linked close.
+                    if(cqe.res == -ECANCELED)
+                        ::close(slot.fd);
+                    else if(cqe.res < 0 && !slot.err)
+                        slot.err = -cqe.res;
+                    release(s);
+                    break;
+                }
+            }
+
+            void reap() {
+                unsigned head = *_cqHead;
+                const unsigned tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+                for(; head != tail && !_broken; head++) {
+                    const io_uring_cqe cqe = _cqes[head & *_cqMask];
+                    __atomic_store_n(_cqHead, head+1, __ATOMIC_RELEASE);
+                    complete(cqe);
+                }
+            }
+
+            // Once abandoned, completions only matter for the files they opened.
+            void drain() {
+                unsigned head = *_cqHead;
+                const unsigned tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+                for(; head != tail; head++) {
+                    const io_uring_cqe& cqe = _cqes[head & *_cqMask];
+                    if((cqe.user_data & 3) == op_open && cqe.res >= 0)
+                        ::close(cqe.res);
+                }
+                __atomic_store_n(_cqHead, head, __ATOMIC_RELEASE);
+            }
+
+            bool idle() const { return _free.size() == _slots.size(); }
+
+        public:
+            static std::unique_ptr<FileBatchWriter::Backend> create(const unsigned depth, const unsigned threads) {
+                std::unique_ptr<IoUringBackend> backend(new IoUringBackend(depth, threads));
+                if(!backend->map(2*backend->_slots.size()) || !backend->supported())
+                    return nullptr;
+                return std::move(backend);
+            }
+
+            IoUringBackend(const unsigned depth, const unsigned threads)
+                : _slots(std::max(depth, 1u)), _threads(threads) {
+                for(unsigned s=_slots.size(); s>0; s--)
+                    _free.push_back(s-1);
+            }
+
+            ~IoUringBackend() {
+                if(_sqMap != MAP_FAILED) {
+                    std::string ignored;
+                    finish(ignored);
+                    if(_broken)
+                        drain();
+                }
+                if(_sqes != MAP_FAILED)
+                    munmap(_sqes, _sqesBytes);
+                if(_cqMap != MAP_FAILED && _cqMap != _sqMap)
+                    munmap(_cqMap, _cqMapBytes);
+                if(_sqMap != MAP_FAILED)
+                    munmap(_sqMap, _sqMapBytes);
+                if(_ring >= 0)
+                    ::close(_ring);
+            }
+
+            const char* name() const { return "io_uring"; }
+
+            bool write(const std::string& filename, const void* data, const size_t bytes) {
+                while(_free.empty() && !_broken) {
+                    submit(1);
+                    reap();
+                }
+                if(_broken) {
+                    if(!_fallback)
+                        _fallback.reset(new ThreadBackend(_threads, _slots.size()));
+                    return _fallback->write(filename, data, bytes);
+                }
+                const unsigned s = _free.back();
+                _free.pop_back();
+                Slot& slot = _slots[s];
+                slot.filename = filename;
+                slot.data.assign(static_cast<const char*>(data), static_cast<const char*>(data)+bytes);
+                slot.fd = -1;
+                slot.err = 0;
+                queueOpen(s);
+                // Keep the kernel busy with a quarter of the slots at a time.
+                if(_pending >= std::max<size_t>(_slots.size()/4, 1))
+                    submit(0);
+                return true;
+            }
+
+            uint64_t finish(std::string& firstError) {
+                reap();
+                while(!idle() && !_broken) {
+                    submit(1);
+                    reap();
+                }
+                uint64_t failed = _failed;
+                firstError = _firstError;
+                _failed = 0;
+                _firstError.clear();
+                if(_fallback) {
+                    std::string fallbackError;
+                    const uint64_t fallbackFailed = _fallback->finish(fallbackError);
+                    if(!failed)
+                        firstError = fallbackError;
+                    failed += fallbackFailed;
+                }
+                return failed;
+            }
+        };
+#endif
+
+        std::unique_ptr<FileBatchWriter::Backend> makeBackend(const FileBatchOptions& options) {
+            const unsigned threads = options.threads ? options.threads
+                : 4*std::max(1u, std::thread::hardware_concurrency());
+#ifdef FRAMEGEN_HAVE_IO_URING
+            if(options.ioUring) {
+                std::unique_ptr<FileBatchWriter::Backend> ring = IoUringBackend::create(options.queueDepth, threads);
+                if(ring)
+                    return ring;
+            }
+#endif
+            return std::unique_ptr<FileBatchWriter::Backend>(new ThreadBackend(threads, options.queueDepth));
+        }
+    } // namespace
+
+    FileBatchWriter::FileBatchWriter(const FileBatchOptions& options) : _options(options) {
+        _backend = makeBackend(options);
+        _stats.backend = _backend->name();
+    }
+
+    FileBatchWriter::~FileBatchWriter() { finish(); }
+
+    bool FileBatchWriter::write(const std::string& filename, const void* data, const size_t bytes) {
+        if(!_started) {
+            _started = true;
+            _start = std::chrono::steady_clock::now();
+            _stats.files = _stats.bytes = _stats.failed = 0;
+            _stats.seconds = 0;
+        }
+#ifdef FRAMEGEN_POSIX
+        if(_options.createDirectories) {
+            const size_t slash = filename.rfind('/');
+            const std::string directory = slash == std::string::npos ? "" : filename.substr(0, slash);
+            if(!directory.empty() && directory != _lastDirectory) {
+                if(mkdir(directory.c_str(), 0755) && errno != EEXIST) {
+                    std::cout << "Error (FileBatchWriter::write()): directory " << directory
+                        << " could not be created: " << strerror(errno) << "." << std::endl;
+                    return false;
+                }
+                _lastDirectory = directory;
+            }
+        }
+#endif
+        if(!_backend->write(filename, data, bytes))
+            return false;
+        _stats.files++;
+        _stats.bytes += bytes;
+        return true;
+    }
+
+    bool FileBatchWriter::finish() {
+        if(!_started)
+            return !_stats.failed;
+        std::string firstError;
+        _stats.failed = _backend->finish(firstError);
+        _stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+        _started = false;
+        if(_stats.failed)
+            std::cout << "Error (FileBatchWriter::finish()): " << _stats.failed << " of " << _stats.files
+                << " files could not be written (first " << firstError << ")." << std::endl;
+        return !_stats.failed;
+    }
+
+} // namespace framegen
@@ -0,0 +1,96 @@
+//==========================================================================
+// Name        : FileBatch.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Asynchronous creation of many small files.
+//============================================================================
+
+#ifndef FRAMEGEN_FILEBATCH_HPP_
+#define FRAMEGEN_FILEBATCH_HPP_
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "Types.hpp"
+
+namespace framegen {
+
+struct FileBatchOptions {
+  // Files being written at once.
+  unsigned queueDepth = 256;
+  // Threads of the thread pool back end; zero selects four per core.
+  unsigned threads = 0;
+  // Use io_uring where the kernel supports it, otherwise the thread pool.
+  bool ioUring = true;
+  // Put every shardFiles consecutive files in their own numbered
+  // subdirectory, so no directory grows large. Zero disables sharding.
+  unsigned long shardFiles = 0;
+  // Create missing parent directories of the files (one level).
+  bool createDirectories = false;
+
+  // Subdirectory, with a trailing slash, of file number i.
+  std::string shardDirectory(unsigned long i) const {
+    return shardFiles ? std::to_string(i / shardFiles) + "/" : "";
+  }
+};
+
+struct FileBatchStats {
+  uint64_t files = 0;
+  uint64_t bytes = 0;
+  uint64_t failed = 0;
+  double seconds = 0;  // From the first write() to finish().
+  const char* backend = "";
+
+  double filesPerSecond() const { return seconds > 0 ? files / seconds : 0; }
+  double MBps() const { return seconds > 0 ? bytes / seconds / 1e6 : 0; }
+};
+
+// ==================================================================
+// Writes many small files without waiting for each one. write() copies the
+// name and contents into one of queueDepth slots and returns; the file is
+// created, written and closed in the background, and finish() waits for all
+// of them.
+//
+// With io_uring, opens are submitted in batches with one system call; every
+// completed open is followed by a write linked to a close, again batched, so
+// creating thousands of files takes a handful of system calls. Otherwise a
+// pool of threads runs open(), write() and close() on the queued files.
+// Should the ring fail, the files in it count as failed and later files go
+// to the thread pool.
+// ==================================================================
+class FileBatchWriter {
+ public:
+  class Backend;
+
+ private:
+  FileBatchOptions _options;
+  std::unique_ptr<Backend> _backend;
+  FileBatchStats _stats;
+  std::string _lastDirectory;
+  bool _started = false;
+  std::chrono::steady_clock::time_point _start;
+
+ public:
+  explicit FileBatchWriter(const FileBatchOptions& options = FileBatchOptions());
+  ~FileBatchWriter();
+  FileBatchWriter(const FileBatchWriter&) = delete;
+  FileBatchWriter& operator=(const FileBatchWriter&) = delete;
+
+  // Queue a file, replacing any existing file of that name. Blocks only while
+  // all slots are in use.
+  bool write(const std::string& filename, const void* data, size_t bytes);
+  // Wait for every queued file. Returns false if any of them failed.
+  bool finish();
+
+  const FileBatchOptions& options() const { return _options; }
+  // "io_uring" or "threads".
+  const char* backend() const { return _stats.backend; }
+  // Complete after finish().
+  const FileBatchStats& stats() const { return _stats; }
+};
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_FILEBATCH_HPP_ */
@@ -0,0 +1,304 @@
+//==========================================================================
+// Name        : Format.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Compile-time descriptions of the WIB frame layouts.
+//============================================================================
+
+#ifndef FRAMEGEN_FORMAT_HPP_
+#define FRAMEGEN_FORMAT_HPP_
+
+#include "Cpu.hpp"
+#include "Types.hpp"
+
+namespace framegen {
+
+// A field of a frame: width bits starting at bit offset of word word.
+struct BitField {
+  unsigned word;
+  unsigned offset;
+  unsigned width;
+};
+
+FRAMEGEN_ALWAYS_INLINE word_t get_field(const word_t* words,
+                                        const BitField f) {
+  return f.width == 32 ? words[f.word]
+                       : (words[f.word] >> f.offset) & ((1u << f.width) - 1);
+}
+
+FRAMEGEN_ALWAYS_INLINE void set_field(word_t* words, const BitField f,
+                                      const word_t value) {
+  if (f.width == 32) {
+    words[f.word] = value;
+    return;
+  }
+  const word_t mask = ((1u << f.width) - 1) << f.offset;
+  words[f.word] = (words[f.word] & ~mask) | ((value << f.offset) & mask);
+}
+
+// Where the two parts of a 12-bit channel sample are stored, relative to the
+// first ADC word of its COLDATA block. The low split bits are in first_word,
+// the rest in second_word.
+struct ChannelLocation {
+  uint8_t first_word;
+  uint8_t first_shift;
+  uint8_t second_word;
+  uint8_t second_shift;
+  uint8_t split;
+  uint16_t first_mask;
+  uint16_t second_mask;
+};
+
+// ==================================================================
+// Layout policies. A layout describes its header fields, block geometry and
+// channel positions with constexpr functions, so the accessors built on it
+// (FrameAccess, the verification kernels) are specialised for it at compile
+// time: a channel read is two table loads and shifts without any branches.
+//
+// Every layout keeps the start of frame and version fields where WIB 1.0 has
+// them; frame_version() reads the version before the layout is known, and
+// dispatch_format() selects the layout from it.
+// ==================================================================
+struct CommonHeader {
+  static constexpr BitField sof() { return BitField{0, 0, 8}; }
+  static constexpr BitField version() { return BitField{0, 8, 5}; }
+};
+
+// WIB frame structure 1.0 (Daniel Gastler): a four-word WIB header, four
+// COLDATA blocks of four header words and 24 ADC words, and a CRC32 word.
+struct WIB1Format : CommonHeader {
+  static const uint8_t version_number = 1;
+  static constexpr const char* name() { return "WIB 1.0"; }
+
+  static const unsigned num_words = 117;
+  static const unsigned num_header_words = 4;
+  static const unsigned num_blocks = 4;
+  static const unsigned num_block_words = 28;
+  static const unsigned num_block_header_words = 4;
+  static const unsigned num_adc_words = 24;
+  static const unsigned num_ch_per_block = 64;
+  static const unsigned num_ch_per_stream = 8;
+  static const unsigned crc_word = 116;
+
+  // WIB header.
+  static constexpr BitField fiber_no() { return BitField{0, 13, 3}; }
+  static constexpr BitField slot_no() { return BitField{0, 16, 5}; }
+  static constexpr BitField crate_no() { return BitField{0, 21, 3}; }
+  static constexpr BitField reserved_1() { return BitField{0, 24, 8}; }
+  static constexpr BitField mm() { return BitField{1, 0, 1}; }
+  static constexpr BitField oos() { return BitField{1, 1, 1}; }
+  static constexpr BitField reserved_2() { return BitField{1, 2, 14}; }
+  static constexpr BitField wib_errors() { return BitField{1, 16, 16}; }
+  static constexpr BitField timestamp_1() { return BitField{2, 0, 32}; }
+  static constexpr BitField timestamp_2() { return BitField{3, 0, 16}; }
+  static constexpr BitField wib_counter() { return BitField{3, 16, 15}; }
+  static constexpr BitField z() { return BitField{3, 31, 1}; }
+
+  // COLDATA block header, relative to the block (see block_field()).
+  static constexpr BitField s1_error() { return BitField{0, 0, 4}; }
+  static constexpr BitField s2_error() { return BitField{0, 4, 4}; }
+  static constexpr BitField block_reserved_1() { return BitField{0, 8, 8}; }
+  static constexpr BitField checksum_a_1() { return BitField{0, 16, 8}; }
+  static constexpr BitField checksum_b_1() { return BitField{0, 24, 8}; }
+  static constexpr BitField checksum_a_2() { return BitField{1, 0, 8}; }
+  static constexpr BitField checksum_b_2() { return BitField{1, 8, 8}; }
+  static constexpr BitField coldata_convert_count() {
+    return BitField{1, 16, 16};
+  }
+  static constexpr BitField error_register() { return BitField{2, 0, 16}; }
+  static constexpr BitField block_reserved_2() { return BitField{2, 16, 16}; }
+  static constexpr BitField hdr() { return BitField{3, 0, 32}; }
+
+  static constexpr unsigned block_word(unsigned block) {
+    return num_header_words + block * num_block_words;
+  }
+  static constexpr unsigned adc_word(unsigned block) {
+    return block_word(block) + num_block_header_words;
+  }
+  static constexpr BitField block_field(unsigned block, BitField f) {
+    return BitField{block_word(block) + f.word, f.offset, f.width};
+  }
+
+  // Checksum A covers the first three of every six ADC words, checksum B the
+  // other three.
+  static constexpr bool checksum_a_word(unsigned i) { return i % 6 < 3; }
+
+  // Two 8-channel streams share every 16-bit half word, the odd stream in
+  // bits 8-15 of each half. Samples are split after 8 bits for even channels
+  // and after 4 for odd ones.
+  static constexpr unsigned first_offset(unsigned ch) { return 12 * ch % 16; }
+  static constexpr unsigned split(unsigned ch) { return 4 * (2 - ch % 2); }
+  static constexpr unsigned first_word(unsigned adc, unsigned ch) {
+    return adc / 2 * 6 + 12 * ch / 16;
+  }
+  static constexpr unsigned second_offset(unsigned ch) {
+    return (first_offset(ch) + split(ch)) % 16;
+  }
+  static constexpr unsigned second_word(unsigned adc, unsigned ch) {
+    return first_word(adc, ch) + (first_offset(ch) + split(ch)) / 16;
+  }
+  // Bit position in the word of an offset in a 16-bit stream.
+  static constexpr unsigned shift(unsigned adc, unsigned offset) {
+    return offset + offset / 8 * 8 + adc % 2 * 8;
+  }
+  static constexpr ChannelLocation location(unsigned adc, unsigned ch) {
+    return ChannelLocation{
+        (uint8_t)first_word(adc, ch),
+        (uint8_t)shift(adc, first_offset(ch)),
+        (uint8_t)second_word(adc, ch),
+        (uint8_t)shift(adc, second_offset(ch)),
+        (uint8_t)split(ch),
+        (uint16_t)((1u << split(ch)) - 1),
+        (uint16_t)((1u << (12 - split(ch))) - 1)};
+  }
+
+  static uint64_t timestamp(const word_t* frame) {
+    const uint64_t ts = (uint64_t)get_field(frame, timestamp_1()) |
+                        (uint64_t)get_field(frame, timestamp_2()) << 32;
+    return get_field(frame, z())
+               ? ts
+               : ts | (uint64_t)get_field(frame, wib_counter()) << 48;
+  }
+  static void set_timestamp(word_t* frame, const uint64_t timestamp) {
+    set_field(frame, timestamp_1(), timestamp);
+    set_field(frame, timestamp_2(), timestamp >> 32);
+    if (!get_field(frame, z())) set_field(frame, wib_counter(), timestamp >> 48);
+  }
+  static uint16_t checksum_a(const word_t* frame, unsigned block) {
+    return get_field(frame, block_field(block, checksum_a_1())) |
+           get_field(frame, block_field(block, checksum_a_2())) << 8;
+  }
+  static uint16_t checksum_b(const word_t* frame, unsigned block) {
+    return get_field(frame, block_field(block, checksum_b_1())) |
+           get_field(frame, block_field(block, checksum_b_2())) << 8;
+  }
+};
+
+// The layout frames are generated in, and assumed for unknown versions.
+typedef WIB1Format DefaultFormat;
+
+// Version stored in a frame, before its layout is known.
+FRAMEGEN_ALWAYS_INLINE uint8_t frame_version(const word_t* frame) {
+  return get_field(frame, CommonHeader::version());
+}
+
+// Call visitor(Format()) with the layout of the given version, so the
+// visitor's templated operator() runs fully specialised for it. Returns
+// false, without calling it, for versions no layout claims.
+template <class Visitor>
+FRAMEGEN_ALWAYS_INLINE bool dispatch_format(const uint8_t version,
+                                            Visitor& visitor) {
+  switch (version) {
+    case WIB1Format::version_number:
+      visitor(WIB1Format());
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Name of the layout of a version, or nullptr.
+inline const char* format_name(const uint8_t version) {
+  switch (version) {
+    case WIB1Format::version_number:
+      return WIB1Format::name();
+    default:
+      return nullptr;
+  }
+}
+
+// ==================================================================
+// Tables generated from the layout functions at compile time.
+// ==================================================================
+template <unsigned... I>
+struct index_list {};
+template <unsigned N, unsigned... I>
+struct make_index_list : make_index_list<N - 1, N - 1, I...> {};
+template <unsigned... I>
+struct make_index_list<0, I...> {
+  typedef index_list<I...> type;
+};
+
+template <class Format, class Indices>
+struct ChannelTableBuilder;
+template <class Format, unsigned... I>
+struct ChannelTableBuilder<Format, index_list<I...> > {
+  static constexpr ChannelLocation entries[sizeof...(I)] = {Format::location(
+      I / Format::num_ch_per_stream, I % Format::num_ch_per_stream)...};
+};
+template <class Format, unsigned... I>
+constexpr ChannelLocation
+    ChannelTableBuilder<Format, index_list<I...> >::entries[sizeof...(I)];
+
+// Location of channel i = adc*num_ch_per_stream + ch of a block.
+template <class Format>
+struct ChannelTable
+    : ChannelTableBuilder<
+          Format, typename make_index_list<Format::num_ch_per_block>::type> {};
+
+template <class Format, class Indices>
+struct ChecksumTableBuilder;
+template <class Format, unsigned... I>
+struct ChecksumTableBuilder<Format, index_list<I...> > {
+  static constexpr word_t a_mask[sizeof...(I)] = {
+      (Format::checksum_a_word(I) ? ~0u : 0u)...};
+};
+template <class Format, unsigned... I>
+constexpr word_t
+    ChecksumTableBuilder<Format, index_list<I...> >::a_mask[sizeof...(I)];
+
+// All ones for the ADC words that feed checksum A, zero for those of B.
+template <class Format>
+struct ChecksumTable
+    : ChecksumTableBuilder<
+          Format, typename make_index_list<Format::num_adc_words>::type> {};
+
+// ==================================================================
+// Channel access through the tables. adcs points to the first ADC word of a
+// block, frame to the first word of a frame.
+// ==================================================================
+template <class Format>
+FRAMEGEN_ALWAYS_INLINE adc_t get_block_channel(const word_t* adcs,
+                                               const unsigned i) {
+  const ChannelLocation& l = ChannelTable<Format>::entries[i];
+  return ((adcs[l.first_word] >> l.first_shift) & l.first_mask) |
+         ((adcs[l.second_word] >> l.second_shift) & l.second_mask) << l.split;
+}
+
+template <class Format>
+FRAMEGEN_ALWAYS_INLINE void set_block_channel(word_t* adcs, const unsigned i,
+                                              const adc_t value) {
+  const ChannelLocation& l = ChannelTable<Format>::entries[i];
+  adcs[l.first_word] =
+      (adcs[l.first_word] & ~((word_t)l.first_mask << l.first_shift)) |
+      (word_t)(value & l.first_mask) << l.first_shift;
+  adcs[l.second_word] =
+      (adcs[l.second_word] & ~((word_t)l.second_mask << l.second_shift)) |
+      (word_t)((value >> l.split) & l.second_mask) << l.second_shift;
+}
+
+template <class Format>
+FRAMEGEN_ALWAYS_INLINE adc_t get_channel(const word_t* frame,
+                                         const unsigned ch) {
+  return get_block_channel<Format>(
+      frame + Format::adc_word(ch / Format::num_ch_per_block),
+      ch % Format::num_ch_per_block);
+}
+
+template <class Format>
+FRAMEGEN_ALWAYS_INLINE void set_channel(word_t* frame, const unsigned ch,
+                                        const adc_t value) {
+  set_block_channel<Format>(
+      frame + Format::adc_word(ch / Format::num_ch_per_block),
+      ch % Format::num_ch_per_block, value);
+}
+
+static_assert(WIB1Format::num_words == num_frame_words &&
+                  WIB1Format::num_ch_per_block * WIB1Format::num_blocks ==
+                      num_ch_per_frame,
+              "The WIB 1.0 layout must match the frame dimensions.");
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_FORMAT_HPP_ */
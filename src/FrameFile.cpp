@@ -0,0 +1,181 @@
+//============================================================================
+// Name        : FrameFile.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Memory-mapped reader for files of consecutive frames.
+//============================================================================
+
+#include "src/FrameFile.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FRAMEGEN_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace framegen {
+
+    namespace {
+        // Returned by frame() for frames that are out of range or could not be read.
+        const Frame empty_frame = Frame();
+    } // namespace
+
+    // std::min() takes it by reference.
+    const size_t FrameFile::window_frames;
+
+    bool FrameFile::open(const std::string& filename, bool useMmap) {
+        close();
+        _filename = filename;
+#ifdef FRAMEGEN_POSIX
+        _fd = ::open(filename.c_str(), O_RDONLY);
+        if(_fd<0) {
+            std::cout << "Error (FrameFile::open()): file " << filename << " could not be opened." << std::endl;
+            return false;
+        }
+        struct stat st;
+        if(fstat(_fd, &st)) {
+            std::cout << "Error (FrameFile::open()): could not determine the size of " << filename << "." << std::endl;
+            close();
+            return false;
+        }
+        _bytes = st.st_size;
+        _Nframes = _bytes / num_frame_bytes;
+        if(useMmap && _bytes>0) {
+            void* map = mmap(nullptr, _bytes, PROT_READ, MAP_SHARED, _fd, 0);
+            if(map != MAP_FAILED)
+                _map = static_cast<const word_t*>(map);
+        }
+#else
+        (void)useMmap;
+        _stream.open(filename, std::ios::binary);
+        if(!_stream) {
+            std::cout << "Error (FrameFile::open()): file " << filename << " could not be opened." << std::endl;
+            return false;
+        }
+        _stream.seekg(0, std::ios::end);
+        _bytes = _stream.tellg();
+        _Nframes = _bytes / num_frame_bytes;
+#endif
+        return true;
+    }
+
+    void FrameFile::close() {
+#ifdef FRAMEGEN_POSIX
+        if(_map)
+            munmap(const_cast<word_t*>(_map), _bytes);
+        if(_fd>=0)
+            ::close(_fd);
+#endif
+        if(_stream.is_open())
+            _stream.close();
+        _map = nullptr;
+        _fd = -1;
+        _bytes = 0;
+        _Nframes = 0;
+        _window.clear();
+        _windowFirst = 0;
+    }
+
+    ConstFrameView FrameFile::frame(size_t i) const {
+        if(i>=_Nframes) {
+            std::cout << "Error (FrameFile::frame()): file " << _filename << " contains fewer than " << i+1
+                << " frames." << std::endl;
+            return ConstFrameView(empty_frame);
+        }
+        if(_map)
+            return ConstFrameView(_map + i*num_frame_words);
+        // Reload the window if the frame is not in it. A failed read leaves no window, so the next call tries again.
+        if(_window.empty() || i<_windowFirst || i>=_windowFirst+_window.size()) {
+            _windowFirst = i - i%window_frames;
+            _window.resize(std::min(window_frames, _Nframes-_windowFirst));
+            if(!read(_windowFirst, _window.size(), _window.data())) {
+                _window.clear();
+                return ConstFrameView(empty_frame);
+            }
+        }
+        return ConstFrameView(_window[i-_windowFirst]);
+    }
+
+    const word_t* FrameFile::frames(size_t first, size_t count, std::vector<Frame>& buffer) const {
+        if(!count)
+            return nullptr;
+        if(first>_Nframes || count>_Nframes-first) {
+            std::cout << "Error (FrameFile::frames()): file " << _filename << " contains fewer than " << first+count
+                << " frames." << std::endl;
+            return nullptr;
+        }
+        if(_map)
+            return _map + first*num_frame_words;
+        if(buffer.size()<count)
+            buffer.resize(count);
+        if(!read(first, count, buffer.data()))
+            return nullptr;
+        return buffer[0].data();
+    }
+
+    bool FrameFile::read(size_t first, size_t count, Frame* out) const {
+        if(first>_Nframes || count>_Nframes-first) {
+            std::cout << "Error (FrameFile::read()): file " << _filename << " contains fewer than " << first+count << " frames." << std::endl;
+            return false;
+        }
+        if(_map) {
+            memcpy(out->data(), _map + first*num_frame_words, count*num_frame_bytes);
+            return true;
+        }
+#ifdef FRAMEGEN_POSIX
+        char* dst = reinterpret_cast<char*>(out);
+        size_t left = count*num_frame_bytes;
+        off_t offset = (off_t)first*num_frame_bytes;
+        while(left) {
+            const ssize_t n = pread(_fd, dst, left, offset);
+            if(n<=0) {
+                std::cout << "Error (FrameFile::read()): could not read from " << _filename << "." << std::endl;
+                return false;
+            }
+            dst += n;
+            offset += n;
+            left -= n;
+        }
+        return true;
+#else
+        std::lock_guard<std::mutex> lock(_readMutex);
+        _stream.seekg((std::streamoff)first*num_frame_bytes);
+        _stream.read(reinterpret_cast<char*>(out), count*num_frame_bytes);
+        return (bool)_stream;
+#endif
+    }
+
+    void FrameFile::adviseSequential() const {
+#ifdef FRAMEGEN_POSIX
+        if(_map)
+            madvise(const_cast<word_t*>(_map), _bytes, MADV_SEQUENTIAL);
+#endif
+    }
+
+    void FrameFile::adviseRandom() const {
+#ifdef FRAMEGEN_POSIX
+        if(_map)
+            madvise(const_cast<word_t*>(_map), _bytes, MADV_RANDOM);
+#endif
+    }
+
+    void FrameFile::prefetch(size_t first, size_t count) const {
+#ifdef FRAMEGEN_POSIX
+        if(!_map || first>=_Nframes)
+            return;
+        count = std::min(count, _Nframes-first);
+        // madvise() needs a page-aligned start.
+        const uintptr_t page = sysconf(_SC_PAGESIZE);
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(_map + first*num_frame_words);
+        const uintptr_t aligned = begin - begin%page;
+        madvise(reinterpret_cast<void*>(aligned), begin - aligned + count*num_frame_bytes, MADV_WILLNEED);
+#else
+        (void)first;
+        (void)count;
+#endif
+    }
+
+} // namespace framegen
@@ -0,0 +1,87 @@
+//==========================================================================
+// Name        : FrameFile.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Memory-mapped reader for files of consecutive frames.
+//============================================================================
+
+#ifndef FRAMEGEN_FRAMEFILE_HPP_
+#define FRAMEGEN_FRAMEFILE_HPP_
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "FrameGen.hpp"
+
+namespace framegen {
+
+// ==================================================================
+// Read-only access to a file of frames. The file is memory-mapped when
+// possible; otherwise frames are read with positioned reads on demand.
+// ==================================================================
+class FrameFile {
+ private:
+  std::string _filename;
+  int _fd = -1;
+  const word_t* _map = nullptr;  // Whole file when mapped.
+  unsigned long long _bytes = 0;
+  size_t _Nframes = 0;
+
+  // Window of frames for frame() when the file is not mapped.
+  mutable std::vector<Frame> _window;
+  mutable size_t _windowFirst = 0;
+  mutable std::mutex _readMutex;  // Only used without POSIX positioned reads.
+  mutable std::ifstream _stream;
+
+ public:
+  static const size_t window_frames = 4096;
+
+  FrameFile() {}
+  explicit FrameFile(const std::string& filename, bool useMmap = true) {
+    open(filename, useMmap);
+  }
+  ~FrameFile() { close(); }
+  FrameFile(const FrameFile&) = delete;
+  FrameFile& operator=(const FrameFile&) = delete;
+
+  // Open a file, mapping it unless useMmap is false or mapping fails.
+  bool open(const std::string& filename, bool useMmap = true);
+  void close();
+
+  bool is_open() const { return _fd >= 0 || _stream.is_open(); }
+  bool mapped() const { return _map != nullptr; }
+  const std::string& filename() const { return _filename; }
+  // Number of complete frames and total file size.
+  size_t size() const { return _Nframes; }
+  unsigned long long bytes() const { return _bytes; }
+  // Bytes after the last complete frame; non-zero means a truncated file.
+  unsigned trailing_bytes() const {
+    return _bytes % num_frame_bytes;
+  }
+
+  // Random access by index. For mapped files the view stays valid until the
+  // file is closed; otherwise only until the next call to frame(). Frames out
+  // of range or that cannot be read print an error and read as all zeros.
+  ConstFrameView frame(size_t i) const;
+  ConstFrameView operator[](size_t i) const { return frame(i); }
+
+  // Contiguous access to frames [first, first+count). Mapped files return a
+  // pointer into the mapping; otherwise the frames are read into buffer. Safe
+  // to call from several threads with separate buffers. Returns nullptr if
+  // the range is empty, out of range or cannot be read.
+  const word_t* frames(size_t first, size_t count,
+                       std::vector<Frame>& buffer) const;
+  // Copy frames [first, first+count) into out.
+  bool read(size_t first, size_t count, Frame* out) const;
+
+  // Access pattern hints for the kernel read-ahead. No-ops when not mapped.
+  void adviseSequential() const;
+  void adviseRandom() const;
+  void prefetch(size_t first, size_t count) const;
+};
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_FRAMEFILE_HPP_ */
@@ -7,63 +7,114 @@
 //============================================================================
 
 #include "src/FrameGen.hpp"
+#include "src/CRC32.hpp"
+#include "src/Checker.hpp"
+#include "src/Compress.hpp"
+#include "src/FrameFile.hpp"
+#include "src/FrameRing.hpp"
+#include "src/FrameWriter.hpp"
+#include "src/Metrics.hpp"
+#include "src/Pack.hpp"
+#include "src/TextWriter.hpp"
+#include "src/Verify.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace framegen {
     
+    //========
+    // Format
+    //========
+    // Definitions of the layout constants, for when they are bound to references.
+    const uint8_t WIB1Format::version_number;
+    const unsigned WIB1Format::num_words;
+    const unsigned WIB1Format::num_header_words;
+    const unsigned WIB1Format::num_blocks;
+    const unsigned WIB1Format::num_block_words;
+    const unsigned WIB1Format::num_block_header_words;
+    const unsigned WIB1Format::num_adc_words;
+    const unsigned WIB1Format::num_ch_per_block;
+    const unsigned WIB1Format::num_ch_per_stream;
+    const unsigned WIB1Format::crc_word;
+    
+    
     //=======
     // Frame
     //=======
-    bool Frame::load(std::string filename, int frameNum) {
-        // Open file which contains frame to load and move pointer to the beginning of the frame.
-        std::ifstream ifile(filename);
-        if(!ifile) {
-            std::cout << "Error (Frame::load): file " << filename << " could not be opened." << std::endl;
+    // Written for any layout, but only instantiated for WIB 1.0 (at the end of this file): FrameFile and the print
+    // functions handle WIB 1.0 frames only.
+    template<class Format>
+    bool BasicFrame<Format>::load(std::string filename, int frameNum) {
+        // Open file which contains frame to load; a single frame is not worth mapping the file for.
+        FrameFile file;
+        if(!file.open(filename, false))
             return false;
-        }
-        ifile.seekg(0,std::ios_base::end);
-        if(ifile.tellg()<(frameNum+1)*num_frame_bytes) {
-            std::cout << "Error (Frame::load): file " << filename << " contains fewer than " << frameNum+1 << " frames." << std::endl << "Be sure to start counting at 0." << std::endl;
+        return load(file, frameNum);
+    }
+    
+    template<class Format>
+    bool BasicFrame<Format>::load(const FrameFile& file, size_t frameNum) {
+        if(frameNum>=file.size()) {
+            std::cout << "Error (Frame::load): file " << file.filename() << " contains fewer than " << frameNum+1 << " frames." << std::endl << "Be sure to start counting at 0." << std::endl;
             return false;
         }
-        
-        load(ifile, frameNum);
-        ifile.close();
-        
-        return true;
+        return file.read(frameNum, 1, this);
     }
     
-    void Frame::load(std::ifstream& strm, int frameNum) {
-        strm.seekg(frameNum*num_frame_bytes);
-        for(unsigned i=0; i<num_frame_words; i++)
-            _binaryData[i] = (uint32_t)strm.get() | strm.get()<<8 | strm.get()<<16 | strm.get()<<24;
+    template<class Format>
+    void BasicFrame<Format>::load(std::ifstream& strm, int frameNum) {
+        strm.seekg((std::streamoff)frameNum*sizeof(_binaryData));
+        strm.read(reinterpret_cast<char*>(_binaryData), sizeof(_binaryData));
     }
     
-    void Frame::load(uint8_t* begin) {
-        for(unsigned i=0; i<num_frame_words; i++) {
+    template<class Format>
+    void BasicFrame<Format>::load(uint8_t* begin) {
+        for(unsigned i=0; i<Format::num_words; i++) {
             const uint32_t* begin32 = reinterpret_cast<uint32_t const*>(begin);
             _binaryData[i] = *(begin32+i);
         }
     }
     
-    void Frame::resetChecksums() {
-        for(unsigned int i=0; i<4; i++) {
-            _frame->block[i].head.set_checksum_a(calculate_checksum_a(i));
-            _frame->block[i].head.set_checksum_b(calculate_checksum_b(i));
+    template<class Format>
+    void BasicFrame<Format>::load(const BasicConstFrameView<Format>& view) {
+        memcpy(_binaryData, view.data(), sizeof(_binaryData));
+    }
+    
+    
+    //=====================
+    // Checksum functions.
+    //=====================
+    void resetChecksums(word_t* frame) {
+        WIBFrame* wib = reinterpret_cast<WIBFrame*>(frame);
+        {
+            FRAMEGEN_METRICS_SAMPLED_SCOPE(metric_checksum, 1, num_frame_bytes);
+            uint16_t checksum_a[4], checksum_b[4];
+            calculate_checksums(frame, checksum_a, checksum_b);
+            for(unsigned int i=0; i<4; i++) {
+                wib->block[i].head.set_checksum_a(checksum_a[i]);
+                wib->block[i].head.set_checksum_b(checksum_b[i]);
+            }
         }
-        _frame->CRC32 = calculate_zCRC32();
+        FRAMEGEN_METRICS_SAMPLED_SCOPE(metric_crc, 1, num_frame_bytes);
+        wib->CRC32 = calculate_zCRC32(frame);
     }
 
-    void Frame::clearReserved() {
-      _frame->head.reserved_1 = 0;
-      _frame->head.reserved_2 = 0;
+    void clearReserved(word_t* frame) {
+      WIBFrame* wib = reinterpret_cast<WIBFrame*>(frame);
+      wib->head.reserved_1 = 0;
+      wib->head.reserved_2 = 0;
       for (unsigned i = 0; i < 4; ++i) {
-        _frame->block[i].head.reserved_1 = 0;
-        _frame->block[i].head.reserved_2 = 0;
+        wib->block[i].head.reserved_1 = 0;
+        wib->block[i].head.reserved_2 = 0;
       }
     }
 
     // Longitudinal redundancy check (16-bit).
-    uint16_t Frame::calculate_checksum_a(unsigned int blockNum, uint16_t init) {
+    uint16_t calculate_checksum_a(const word_t* frame, unsigned int blockNum, uint16_t init) {
         if(blockNum>3) {
             std::cout << "Error: invalid block number passed to checksum_A(). (Valid range: 0-3.)" << std::endl;
             return 0;
@@ -71,15 +122,15 @@ namespace framegen {
         uint16_t result = init;
         for(unsigned int i=0; i<4; i++) {
             for(unsigned int j=0; j<3; j++) {
-                result ^= getBitRange(_binaryData[8+blockNum*28+i*2*3+j],0,15);
-                result ^= getBitRange(_binaryData[8+blockNum*28+i*2*3+j],16,31);
+                result ^= getBitRange(frame[8+blockNum*28+i*2*3+j],0,15);
+                result ^= getBitRange(frame[8+blockNum*28+i*2*3+j],16,31);
             }
         }
         return result;
     }
     
     // Modular checksum (16-bit).
-    uint16_t Frame::calculate_checksum_b(unsigned int blockNum, uint16_t init) {
+    uint16_t calculate_checksum_b(const word_t* frame, unsigned int blockNum, uint16_t init) {
         if(blockNum>3) {
             std::cout << "Error: invalid block number passed to checksum_B(). (Valid range: 0-3.)" << std::endl;
             return 0;
@@ -87,94 +138,107 @@ namespace framegen {
         uint16_t result = init;
         for(unsigned int i=0; i<4; i++) {
             for(unsigned int j=0; j<3; j++) {
-                result += getBitRange(_binaryData[8+blockNum*28+(i*2+1)*3+j],0,15);
-                result += getBitRange(_binaryData[8+blockNum*28+(i*2+1)*3+j],16,31);
+                result += getBitRange(frame[8+blockNum*28+(i*2+1)*3+j],0,15);
+                result += getBitRange(frame[8+blockNum*28+(i*2+1)*3+j],16,31);
             }
         }
         return -result;
     }
     
     // Cyclic redundancy check (32-bit).
-    uint32_t Frame::calculate_CRC32(uint32_t padding, uint32_t CRC32_Polynomial) {
-        uint32_t shiftReg = _binaryData[0]; // Shifting register.
-        if(shiftReg&1)
-            shiftReg ^= CRC32_Polynomial;
-        // Shift through the data.
-        for(unsigned i=0; i<(num_frame_words-2)*32; i++) { // The register shifts through FRAME_LENGTH-1 32-bit words and is 32 bits long.
-            // Perform XOR on the shifting register if the leading bit is 1 and shift.
-            if(shiftReg & 1) {
-                shiftReg = shiftReg>>1 | (_binaryData[i/32+1]>>(i%32)&1)<<31;
-                shiftReg ^= CRC32_Polynomial;
-            } else
-                shiftReg = shiftReg>>1 | (_binaryData[i/32+1]>>(i%32)&1)<<31;
-        }
-        
-        return shiftReg^padding;
+    uint32_t calculate_CRC32(const word_t* frame, uint32_t padding, uint32_t CRC32_Polynomial) {
+        return crc32_frame(frame, CRC32_Polynomial)^padding;
     }
     
     // Zlib's cyclic redundancy check (32-bit).
-    uint32_t Frame::calculate_zCRC32(uint32_t padding) {
-        uint32_t crc = crc32(0L, Z_NULL, 0);
-        uint8_t* p;
-        for(unsigned i=0; i<num_frame_words-2; i++) {
-            p = (uint8_t*)&_binaryData[i];
-            for(int j=0; j<4; j++)
-                crc = crc32(crc, p++, 1);
-        }
-        //std::cout << std::hex << "0x" << (crc^padding) << std::endl;
-        return crc^padding;
+    uint32_t calculate_zCRC32(const word_t* frame, uint32_t padding) {
+        return zcrc32_frame(frame)^padding;
     }
     
     // Overloaded frame print functions.
-    bool Frame::print(std::string filename, char opt) { return framegen::print(*this, filename, opt); }
-    bool Frame::print(std::ofstream& strm, char opt) { return framegen::print(*this, strm, opt); }
+    template<class Format>
+    bool BasicFrame<Format>::print(std::string filename, char opt) { return framegen::print(*this, filename, opt); }
+    template<class Format>
+    bool BasicFrame<Format>::print(std::ofstream& strm, char opt) { return framegen::print(*this, strm, opt); }
+    template<class Format>
+    bool BasicFrame<Format>::print(FrameWriter& writer) { return framegen::print(*this, writer); }
+    
+    template class BasicFrame<WIB1Format>;
     
     
     //==========
     // FrameGen
     //==========
-    void FrameGen::fill() {
+    TimestampClock::TimestampClock() {
+        using namespace std::chrono;
+        _next = duration_cast<nanoseconds>(high_resolution_clock::now().time_since_epoch()).count();
+    }
+
+    TimestampClock& TimestampClock::shared() {
+        static TimestampClock clock;
+        return clock;
+    }
+    
+    void FrameGen::fill() { fill(_frame, _noise, signal(), _clock->claim(1), _frameNo); }
+    
+    // Fill a frame from the given noise generator, adding pulses from the signal generator if there is one. The signal
+    // follows frameNo, the frame's place in this generator's stream, rather than the timestamp, which other
+    // generators on the same clock interleave with. Only reads class parameters, so worker threads can share it.
+    void FrameGen::fill(Frame& frame, NoiseGen& noise, SignalGen* signal, const uint64_t timestamp,
+                        const uint64_t frameNo) const {
+        FRAMEGEN_METRICS_SCOPE(metric_fill, 1, num_frame_bytes);
         // Header.
-        _frame.set_sof(0);
-        _frame.set_version(1); // Version notation format subject to change.
-        _frame.set_fiber_no(rand()%8);
-        _frame.set_crate_no(rand()%32);
-        _frame.set_slot_no(rand()%8);
-        
-        _frame.set_wib_errors(_randDouble(_mt)<_errProb);
+        frame.set_sof(0);
+        frame.set_version(Frame::format::version_number); // Version notation format subject to change.
+        if(_hasLink) {
+            frame.set_fiber_no(_link.fiber);
+            frame.set_crate_no(_link.crate);
+            frame.set_slot_no(_link.slot);
+        } else {
+            frame.set_fiber_no(noise.next()%8);
+            frame.set_crate_no(noise.next()%32);
+            frame.set_slot_no(noise.next()%8);
+        }
         
-        _frame.set_z(0);
+        frame.set_wib_errors(noise.uniform()<_errProb);
         
-        { // Small timestamp scope.
-            using namespace std::chrono;
-            static nanoseconds time = duration_cast<nanoseconds>(high_resolution_clock::now().time_since_epoch());
-            _frame.set_timestamp(duration_cast<nanoseconds>(time).count());
-            time += nanoseconds(500);
-        }
+        frame.set_z(0);
+        frame.set_timestamp(timestamp);
 
-        // Produce four COLDATA blocks. (Random numbers have 16 bits each.)
-        std::binomial_distribution<int> _randInt(_noiseAmplitude*2, 0.5);
-        int randnum = 0; // Temporary variable to make sure random values are positive.
+        // Produce four COLDATA blocks: 256 10-bit words of noise. (Constrained up to 12 bits by the frame structure.)
+        adc_t adcs[num_ch_per_frame];
+        noise.generate(adcs);
+        if(signal)
+            signal->apply(adcs, frameNo);
+        pack(frame, adcs);
         for(int i=0; i<4; i++) {
-            // Build 64 10-bit words of COLDATA. (Constrained up to 12 bits by the frame structure.)
-            for(int j=0; j<64; j++) {
-                do {
-                    randnum = _randInt(_mt)-_noiseAmplitude+_noisePedestal;
-                } while(randnum<0);
-                _frame.set_channel(i,j/8,j%8,randnum);
-            }
-
-            _frame.set_s1_error(i, _randDouble(_mt) < _errProb);
-            _frame.set_s2_error(i, _randDouble(_mt) < _errProb);
+            frame.set_s1_error(i, noise.uniform() < _errProb);
+            frame.set_s2_error(i, noise.uniform() < _errProb);
 
             // The Coldata convert count and error register are not set of yet.
         }
         
         // Clear reserved space.
-        _frame.clearReserved();
+        frame.clearReserved();
 
         // Set the individual COLDATA checksums and the CRC32 over the entire frame.
-        _frame.resetChecksums();
+        frame.resetChecksums();
+    }
+    
+    // Workers share the seed of the main stream, so the signal does not depend on how the frames are split.
+    std::vector<SignalGen> FrameGen::workerSignals(const unsigned threads) const {
+        std::vector<SignalGen> signals;
+        if(_signal.options().enabled())
+            for(unsigned t=0; t<threads; t++)
+                signals.push_back(SignalGen(_signal.options(), _signal.seed()));
+        return signals;
+    }
+    
+    // Seed the noise generator and apply the flat noise parameters.
+    void FrameGen::initNoise() {
+        _noise.seed((uint64_t)_rd() << 32 | _rd());
+        setPedestal(_noisePedestal);
+        setAmplitude(_noiseAmplitude);
     }
     
     // Main generator function: builds frames and calls the fill function.
@@ -183,24 +247,41 @@ namespace framegen {
             std::cout << "Generating frames." << std::endl;
         else
             std::cout << "Generating frames at path " << _path << "." << std::endl;
-        for(unsigned long i=0; i<Nframes; i++) {
-            // Open frame, fill it and close it.
-            std::ofstream ofile(getFileName(i));
-            if(!ofile) {
-                std::cout << "Error (generate()): " << getFileName(i) << " could not be opened." << std::endl;
-                std::cout << "\t(You will have to create the path " << _path << " if you haven't already.)" << std::endl;
-                return;
-            }
+        if(opt!='b' && !isTextFormat(opt)) {
+            std::cout << "Error (generate()): unknown format '" << opt << "'." << std::endl;
+            return;
+        }
+        // Every frame is a file of its own. They are handed to a FileBatchWriter, which creates and writes them in
+        // the background, many at a time; the text formats are formatted here first, header and footer included.
+        FileBatchOptions options = _fileBatch;
+        options.createDirectories = options.createDirectories || options.shardFiles;
+        FileBatchWriter writer(options);
+        const std::string header = textHeader(opt, 1), footer = textFooter(opt);
+        std::vector<char> text(header.size() + max_text_frame_chars + footer.size());
+        memcpy(text.data(), header.data(), header.size());
+        bool ok = true;
+        for(unsigned long i=0; i<Nframes && ok; i++) {
             fill();
-            _frame.print(ofile, opt);
-            ofile.close();
-            
-            // Keep track of progress.
-            if((i*100)%Nframes==0)
-                std::cout << i*100/Nframes << "%\r" << std::flush;
+            if(opt=='b') {
+                FRAMEGEN_METRICS_SCOPE(metric_write, 1, num_frame_bytes);
+                ok = writer.write(getFileName(i), _frame.data(), num_frame_bytes);
+            } else {
+                size_t size = header.size();
+                size += formatFrame(_frame, opt, text.data()+size);
+                memcpy(text.data()+size, footer.data(), footer.size());
+                FRAMEGEN_METRICS_SCOPE(metric_write, 1, num_frame_bytes);
+                ok = writer.write(getFileName(i), text.data(), size+footer.size());
+            }
             _frameNo++;
         }
-        std::cout << "    \tDone." << std::endl;
+        ok = writer.finish() && ok;
+        _fileBatchStats = writer.stats();
+        if(!ok) {
+            std::cout << "\t(You will have to create the path " << _path << " if you haven't already.)" << std::endl;
+            return;
+        }
+        std::cout << "    \tDone (" << _fileBatchStats.filesPerSecond() << " files/s, " << writer.backend() << ")."
+            << std::endl;
     }
     
     // Overloaded generate function to handle new prefixes.
@@ -215,26 +296,179 @@ namespace framegen {
             std::cout << "Generating frames." << std::endl;
         else
             std::cout << "Generating frames at path " << _path << "." << std::endl;
-        // Open frame, fill it and close it.
+        // Open frame, fill it and close it. Binary output goes through a FrameWriter with the whole file
+        // preallocated; the text formats through a TextWriter, which writes the 'f' header and footer only once.
         std::string filename = _path+_prefix+_suffix+_extension;
-        std::ofstream ofile(filename);
-        if(!ofile) {
-            std::cout << "Error (generate()): " << filename << " could not be opened." << std::endl;
-            return;
+        FrameWriter writer;
+        TextWriter text;
+        std::function<bool(const Frame*, unsigned long)> write;
+        if(opt=='b') {
+            writer.setDirect(_directIO);
+            writer.setPreallocate((unsigned long long)Nframes*num_frame_bytes);
+            if(!writer.open(filename)) {
+                std::cout << "Error (generate()): " << filename << " could not be opened." << std::endl;
+                return;
+            }
+            write = [&](const Frame* frames, unsigned long count) {
+                FRAMEGEN_METRICS_SCOPE(metric_write, count, count*num_frame_bytes);
+                return writer.write(frames, count);
+            };
+        } else {
+            if(!text.open(filename, opt, Nframes)) {
+                std::cout << "Error (generate()): " << filename << " could not be opened." << std::endl;
+                return;
+            }
+            write = [&](const Frame* frames, unsigned long count) {
+                FRAMEGEN_METRICS_SCOPE(metric_write, count, count*num_frame_bytes);
+                return text.write(frames, count);
+            };
+        }
+        // Stop at the first failed write; the writers have already said why.
+        bool written = true;
+        if(_threads>1) {
+            written = generateParallel(write, Nframes);
+        } else {
+            for(unsigned long i=0; i<Nframes && written; i++) {
+                fill();
+                written = write(&_frame, 1);
+                _frameNo++;
+            }
         }
-        for(unsigned long i=0; i<Nframes; i++) {
-            fill();
-            framegen::print(_frame, ofile, opt, Nframes);
-            
-            // Keep track of progress.
-            if((i*100)%Nframes==0)
-                std::cout << i*100/Nframes << "%\r" << std::flush;
-            _frameNo++;
+        const bool closed = opt=='b' ? writer.close() : text.close();
+        if(!written || !closed) {
+            std::cout << "Error (generate()): " << filename << " could not be written." << std::endl;
+            return;
         }
-        ofile.close();
         std::cout << "    \tDone." << std::endl;
     }
     
+    // Parallel back end of generateSingleFile(). Workers fill batches of frames into a ring of slots, each from its
+    // own noise stream, while this thread writes the slots out in order. Batch b always goes to slot b%slots and is
+    // written as batch b, so the output is in timestamp order no matter which worker finishes first.
+    bool FrameGen::generateParallel(const std::function<bool(const Frame*, unsigned long)>& write, const unsigned long Nframes) {
+        const unsigned long batchFrames = 256;
+        const unsigned long Nbatches = (Nframes+batchFrames-1)/batchFrames;
+        const unsigned Nslots = 2*_threads;
+        const uint64_t firstTimestamp = _clock->claim(Nframes);
+        const uint64_t firstFrame = _frameNo;
+        
+        struct Slot {
+            std::vector<Frame> frames;
+            unsigned long batch; // Batch this slot is waiting for.
+            bool ready;
+        };
+        std::vector<Slot> slots(Nslots);
+        for(unsigned s=0; s<Nslots; s++) {
+            slots[s].frames.resize(batchFrames);
+            slots[s].batch = s;
+            slots[s].ready = false;
+        }
+        std::mutex mutex;
+        std::condition_variable filled, written;
+        std::atomic<unsigned long> nextBatch(0);
+        bool failed = false; // A write failed; guarded by mutex.
+        
+        // Seeded from this generator's stream, like generateBuffer(), so seeding noise() makes the output
+        // reproducible.
+        std::vector<NoiseGen> noise(_threads, _noise);
+        for(unsigned t=0; t<_threads; t++)
+            noise[t].seed(_noise.next());
+        std::vector<SignalGen> signals = workerSignals(_threads);
+        
+        auto work = [&](unsigned t) {
+            for(unsigned long b=nextBatch++; b<Nbatches; b=nextBatch++) {
+                Slot& slot = slots[b%Nslots];
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    written.wait(lock, [&] { return failed || (slot.batch==b && !slot.ready); });
+                    if(failed)
+                        return;
+                }
+                const unsigned long first = b*batchFrames;
+                const unsigned long count = std::min(batchFrames, Nframes-first);
+                SignalGen* signal = signals.empty() ? nullptr : &signals[t];
+                for(unsigned long i=0; i<count; i++)
+                    fill(slot.frames[i], noise[t], signal, firstTimestamp + frame_timestamp_step*(first+i), firstFrame+first+i);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    slot.ready = true;
+                }
+                filled.notify_all();
+            }
+        };
+        std::vector<std::thread> workers;
+        for(unsigned t=0; t<_threads; t++)
+            workers.push_back(std::thread(work, t));
+        
+        for(unsigned long b=0; b<Nbatches; b++) {
+            Slot& slot = slots[b%Nslots];
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                filled.wait(lock, [&] { return slot.ready; });
+            }
+            const unsigned long first = b*batchFrames;
+            const unsigned long count = std::min(batchFrames, Nframes-first);
+            if(!write(slot.frames.data(), count)) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    failed = true;
+                }
+                written.notify_all();
+                break;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                slot.ready = false;
+                slot.batch += Nslots;
+            }
+            written.notify_all();
+        }
+        for(unsigned t=0; t<_threads; t++)
+            workers[t].join();
+        _frameNo += Nframes;
+        return !failed;
+    }
+    
+    void FrameGen::generateBuffer(std::vector<Frame>& frames, const unsigned long Nframes) {
+        frames.resize(Nframes);
+        const uint64_t firstTimestamp = _clock->claim(Nframes);
+        const unsigned threads = std::max(1ul, std::min<unsigned long>(_threads, Nframes/256));
+        if(threads==1) {
+            for(unsigned long i=0; i<Nframes; i++)
+                fill(frames[i], _noise, signal(), firstTimestamp + frame_timestamp_step*i, _frameNo+i);
+        } else {
+            std::vector<NoiseGen> noise(threads, _noise);
+            for(unsigned t=0; t<threads; t++)
+                noise[t].seed(_noise.next());
+            std::vector<SignalGen> signals = workerSignals(threads);
+            std::vector<std::thread> workers;
+            for(unsigned t=0; t<threads; t++)
+                workers.push_back(std::thread([&, t] {
+                    SignalGen* signal = signals.empty() ? nullptr : &signals[t];
+                    for(unsigned long i=Nframes*t/threads; i<Nframes*(t+1)/threads; i++)
+                        fill(frames[i], noise[t], signal, firstTimestamp + frame_timestamp_step*i, _frameNo+i);
+                }));
+            for(unsigned t=0; t<threads; t++)
+                workers[t].join();
+        }
+        _frameNo += Nframes;
+    }
+    
+    bool FrameGen::generate(FrameRing& ring, const unsigned long Nframes, const size_t batchFrames) {
+        for(unsigned long done=0; done<Nframes; ) {
+            const FrameRing::Batch batch = ring.claimWait(std::min<unsigned long>(batchFrames, Nframes-done));
+            if(!batch.count)
+                return false;
+            const uint64_t firstTimestamp = _clock->claim(batch.count);
+            for(size_t i=0; i<batch.count; i++)
+                fill(batch.frames[i], _noise, signal(), firstTimestamp + frame_timestamp_step*i, _frameNo+i);
+            ring.publish(batch);
+            done += batch.count;
+            _frameNo += batch.count;
+        }
+        return true;
+    }
+    
     // Overloaded generate function to handle new prefixes.
     void FrameGen::generateSingleFile(const std::string& newPrefix, const unsigned long Nframes, char opt) {
         _prefix = newPrefix;
@@ -258,16 +492,24 @@ namespace framegen {
         return strm? true: false;
     }
     
-    // Overloaded check functions to handle a range of files.
+    // Overloaded check functions to handle a range of files. The files are verified in parallel; every file is
+    // checked, and the result is false if any of them could not be read or failed a CRC.
     const bool FrameGen::check(const unsigned int begin, const unsigned int end) {
         if(_path == "")
             std::cout << "Checking frames." << std::endl;
         else
             std::cout << "Checking frames at path " << _path << "." << std::endl;
+        CheckOptions options;
+        options.verbose = true;
+        options.keepStatus = false;
+        return checkReport(begin, end, options).ok();
+    }
+    
+    CheckReport FrameGen::checkReport(const unsigned int begin, const unsigned int end, const CheckOptions& options) {
+        std::vector<std::string> filenames;
         for(unsigned int i=begin; i<end; i++)
-            if(!framegen::check(getFileName(i)))
-                return false;
-        return true;
+            filenames.push_back(getFileName(i));
+        return checkFiles(filenames, options);
     }
     
     
@@ -281,88 +523,31 @@ namespace framegen {
             std::cout << "Error (framegen::check()): file " << filename << " could not be opened." << std::endl;
             return false;
         }
-        
-        // Check checksums.
-        for(int i=0; i<4; i++) {
-            if(frame.calculate_checksum_a(i, frame.checksum_a(i)))
-                std::cout << "Frame " << filename << ", COLDATA block " << i+1 << "/4 contains an error in checksum A." << std::endl;
-            if(frame.calculate_checksum_b(i, frame.checksum_b(i)))
-                std::cout << "Frame " << filename << ", COLDATA block " << i+1 << "/4 contains an error in checksum B." << std::endl;
-        }
-        if(frame.calculate_zCRC32(frame.CRC32())) {
-            std::cout << "Frame " << filename << " failed its cyclic redundancy check." << std::endl;
-            return false;
-        }
-        
-        // Check errors and produce a warning.
-        if(frame.wib_errors()) // WIB_Errors
-            std::cout << "Warning: WIB error bit set in frame " << filename << "." << std::endl;
-        for(int i=0; i<4; i++){
-            if(frame.s1_error(i)) // Stream errors
-                std::cout << "Warning: S1 error bit set in frame " << filename << ", block " << i+1 << "/4." << std::endl;
-            if(frame.s2_error(i)) // Stream errors
-                std::cout << "Warning: S2 error bit set in frame " << filename << ", block " << i+1 << "/4." << std::endl;
-        }
-        
-        return true;
+        return printStatus(verify_frame(frame.data()), filename);
     }
     
-    // Function to check frames within a single file.
+    // Function to check frames within a single file. All frames are checked, split across all cores.
     const bool checkSingleFile(const std::string& filename) {
-        // Open file.
-        std::ifstream ifile(filename, std::ios::binary);
-        if(!ifile) {
-            std::cout << "Error (check()): could not open file " << filename << "." << std::endl;
-            return false;
-        }
         std::cout << "Checking frames." << std::endl;
-        
-        // Get number of frames and check whether this is an integer.
-        ifile.seekg(0,ifile.end);
-        if(ifile.tellg()%(num_frame_bytes)) {
-            std::cout << "Error: file " << filename << " contains unreadable frames." << std::endl;
-            return false;
-        }
-        int numberOfFrames = ifile.tellg()/(num_frame_bytes);
-        ifile.seekg(0,ifile.beg);
-        
-        Frame frame;
-        
-        bool result = true;
-        
-        for(int j=0; j<numberOfFrames; j++) {
-            // Load data from file.
-            frame.load(ifile,j);
-            
-            // Check checksums.
-            for(int i=0; i<4; i++) {
-                if(frame.calculate_checksum_a(i, frame.checksum_a(i)))
-                    std::cout << "Frame " << j << " of file " << filename << ", COLDATA block " << i+1 << "/4 contains an error in checksum A." << std::endl;
-                if(frame.calculate_checksum_b(i, frame.checksum_b(i)))
-                    std::cout << "Frame " << j << " of file " << filename << ", COLDATA block " << i+1 << "/4 contains an error in checksum B." << std::endl;
-            }
-            if(frame.calculate_zCRC32(frame.CRC32())) {
-                std::cout << "Frame " << j << " of file " << filename << " failed its cyclic redundancy check." << std::endl;
-                return false;
-            }
-            
-            // Check errors and produce a warning.
-            if(frame.wib_errors()) // WIB_Errors
-                std::cout << "Warning: WIB error bit set in frame " << j << " of file " << filename << "." << std::endl;
-            for(int i=0; i<4; i++){
-                if(frame.s1_error(i)) // Stream errors
-                    std::cout << "Warning: S1 error bit set in frame " << filename << ", block " << i+1 << "/4." << std::endl;
-                if(frame.s2_error(i)) // Stream errors
-                    std::cout << "Warning: S2 error bit set in frame " << filename << ", block " << i+1 << "/4." << std::endl;
-            }
-        }
-        
-        ifile.close();
-        return result;
+        CheckOptions options;
+        options.verbose = true;
+        options.keepStatus = false;
+        return checkFile(filename, options).ok();
     }
     
     // Frame print functions.
     bool print(const Frame& frame, std::string filename, char opt, const int Nframes) {
+        // Binary frames are appended with a single write().
+        if(opt=='b') {
+            FrameWriter writer;
+            writer.setBufferSize(FrameWriter::alignment);
+            if(!writer.open(filename, true)) {
+                std::cout << "Error (Frame::print): file " << filename << " could not be accessed." << std::endl;
+                return false;
+            }
+            writer.write(frame);
+            return writer.close();
+        }
         std::ofstream oframe(filename, std::ios_base::app);
         if(!oframe) {
             std::cout << "Error (Frame::print): file " << filename << " could not be accessed." << std::endl;
@@ -377,40 +562,28 @@ namespace framegen {
         if(!strm)
             return false;
         // b = binary, h = hexadecimal, o = octal, d = decimal, f = header file
+        // The text formats are rendered into a local buffer and handed to the stream in one write.
+        char text[max_text_frame_chars];
         switch(opt) {
             case 'b':
-                for(unsigned i=0; i<num_frame_words; i++)
-                    strm << (char)(frame._binaryData[i]) << (char)(frame._binaryData[i]>>8) << (char)(frame._binaryData[i]>>16) << (char)(frame._binaryData[i]>>24);
+                // Words are stored little-endian, as they are in memory.
+                strm.write(reinterpret_cast<const char*>(frame.data()), num_frame_bytes);
                 break;
             case 'h':
-                for(unsigned i=0; i<num_frame_words; i++)
-                    strm << std::hex << std::setfill('0') << "0x" << std::setw(8) << frame._binaryData[i] << std::endl;
-                break;
             case 'o':
-                for(unsigned i=0; i<num_frame_words; i++)
-                    strm << std::oct << std::setfill('0') << "0" << std::setw(11) << frame._binaryData[i] << std::endl;
-                break;
             case 'd':
-                for(unsigned i=0; i<num_frame_words; i++)
-                    strm << std::setfill('0') << std::setw(10) << frame._binaryData[i] << std::endl;
+                strm.write(text, formatFrame(frame, opt, text));
                 break;
             case 'f':
-                // Add a header if this is the first frame. Otherwise adjust the cursor accordingly.
-                if(strm.tellp()==0)
-                    strm << "#ifndef PROTODUNE_H__\n#define PROTODUNE_H__\n\n"
-                    << "const uint32_t PROTODUNE_FRAMESIZE = 117*4;\n"
-                    << "const uint32_t PROTODUNE_FRAMENUM = " << Nframes << ";\n\n"
-                    << "uint32_t PROTODUNE_DATA[] = {";
-                else {
-                    strm.seekp(-11, std::ios::end);
-                    strm << ",";
-                }
-                // Enter data.
-                strm << std::endl << std::hex << std::setfill('0') << "    0x" << std::setw(8) << frame._binaryData[0];
-                for(unsigned i=1; i<num_frame_words; i++) {
-                    strm << "," << std::endl << std::hex << std::setfill('0') << "    0x" << std::setw(8) << frame._binaryData[i];
+                // Add a header if this is the first frame. Otherwise overwrite the footer of the previous one.
+                if(strm.tellp()==0) {
+                    strm << textHeader(opt, Nframes);
+                    strm.write(text, formatFrame(frame, opt, text, true));
+                } else {
+                    strm.seekp(-(std::streamoff)textFooter(opt).size(), std::ios::end);
+                    strm.write(text, formatFrame(frame, opt, text, false));
                 }
-                strm << std::endl << "};\n\n#endif";
+                strm << textFooter(opt);
                 break;
             default:
                 std::cout << "Error (Frame::print()): unknown print option '" << opt << "'." << std::endl;
@@ -421,106 +594,42 @@ namespace framegen {
     }
     
     
+    bool print(const Frame& frame, FrameWriter& writer) { return writer.write(frame); }
+    
+    
     //============================
     // Compression/decompression.
     //============================
-    // Function to compress frames or sets of frames.
-    const bool compressFile(const std::string& filename) {
-        // Open original file.
-        std::ifstream ifcomp(filename, std::ios::binary);
-        if(!ifcomp) {
-            std::cout << "Error (compress()): file " << filename << " could not be openend." << std::endl;
-            return false;
-        }
-        
-        // Get file length and create buffer (to be changed to shifting window).
-        ifcomp.seekg(0,ifcomp.end);
-        unsigned long iflength = ifcomp.tellg();
-        ifcomp.seekg(0,ifcomp.beg);
-        
-        Bytef* ifbuff = new Bytef[iflength];
-        ifcomp.read((char*)ifbuff,iflength);
-        
-        // Create file to output compressed data into.
-        std::ofstream ofcomp(filename+".comp", std::ios::binary);
-        if(!ofcomp) {
-            std::cout << "Error (compress()): file " << filename+".comp" << " could not be created." << std::endl;
+    // Function to compress frames or sets of frames. The file is streamed through in fixed-size chunks and replaced
+    // by a ".comp" container (see Compress.hpp).
+    const bool compressFile(const std::string& filename) { return compressFile(filename, CompressOptions()); }
+    
+    const bool compressFile(const std::string& filename, const CompressOptions& options, CompressorStats* stats) {
+        if(!compressFile(filename, filename+".comp", options, stats))
             return false;
-        }
-        
-        // Create buffer for compressed file and perform the compression (with the compression function from zlib).
-        unsigned long oflength = iflength*1.1 + 12; // The new buffer needs to be longer than the original only until compression is complete.
-        Bytef* ofbuff = new Bytef[oflength];
-        switch(::compress(ofbuff, &oflength, ifbuff, iflength)) {
-            case Z_OK:          break;
-            case Z_MEM_ERROR:   std::cout << "Error (compress()): out of memory." << std::endl;                   return false;
-            case Z_BUF_ERROR:   std::cout << "Error (compress()): output buffer not large enough." << std::endl;  return false;
-            case Z_DATA_ERROR:  std::cout << "Error (compress()): the data was corrupted." << std::endl;          return false;
-            default:            std::cout << "Error (compress()): unknown error code." << std::endl;              return false;
-        }
-        
-        ofcomp.write((char*)ofbuff,oflength);
-        
-        // Cleanup.
-        delete[] ifbuff;
-        delete[] ofbuff;
         remove(filename.c_str());
-        ifcomp.close();
-        ofcomp.close();
-        
         return true;
     }
     
-    const bool decompressFile(const std::string& filename) {
+    // Containers and plain zlib files from older versions are both accepted.
+    const bool decompressFile(const std::string& filename, CompressorStats* stats) {
         // Check whether the filename has the right extension.
         bool compExt = true;
         // Compare filename extension to ".comp".
-        if(strcmp(filename.substr(filename.rfind("."),filename.length()).c_str(), ".comp")) {
+        if(filename.length()<5 || filename.compare(filename.length()-5, 5, ".comp")) {
             std::cout << "Warning: the file " << filename << " does not have the default \".comp\" extension." << std::endl;
             compExt = false;
         }
-        // Open original file.
-        std::ifstream ifdecomp(filename, std::ios::binary);
-        if(!ifdecomp) {
-            std::cout << "Error (decompress()): file " << filename << " could not be opened." << std::endl;
+        // Without the extension the output would overwrite the input, so decompress next to it first.
+        const std::string output = compExt? filename.substr(0,filename.length()-5): filename+".decomp";
+        if(!decompressFile(filename, output, stats))
             return false;
-        }
-        
-        // Get file length and create buffer (to be changed to shifting window).
-        ifdecomp.seekg(0,ifdecomp.end);
-        unsigned long iflength = ifdecomp.tellg();
-        ifdecomp.seekg(0,ifdecomp.beg);
-        
-        Bytef* ifbuff = new Bytef[iflength];
-        ifdecomp.read((char*)ifbuff,iflength);
-        
-        // Create file to output compressed data into.
-        std::ofstream ofdecomp(compExt? filename.substr(0,filename.length()-5): filename);
-        if(!ofdecomp) {
-            std::cout << "Error (decompress()): file " << (compExt? filename.substr(0,filename.length()-5): filename) << " could not be created." << std::endl;
+        if(compExt)
+            remove(filename.c_str());
+        else if(rename(output.c_str(), filename.c_str())) {
+            std::cout << "Error (decompress()): file " << filename << " could not be replaced." << std::endl;
             return false;
         }
-        
-        // Create buffer for decompressed file and perform the decompression (with the decompression function from zlib).
-        unsigned long oflength = iflength*30; // Just to be safe.
-        Bytef* ofbuff = new Bytef[oflength];
-        switch(::uncompress(ofbuff, &oflength, ifbuff, iflength)) {
-            case Z_OK:          break;
-            case Z_MEM_ERROR:   std::cout << "Error (decompress()): out of memory." << std::endl;                     return false;
-            case Z_BUF_ERROR:   std::cout << "Error (decompress()): output buffer not large enough." << std::endl;    return false;
-            case Z_DATA_ERROR:  std::cout << "Error (decompress()): the data was corrupted." << std::endl;            return false;
-            default:            std::cout << "Error (decompress()): unknown error code." << std::endl;                return false;
-        }
-        
-        ofdecomp.write((char*)ofbuff,oflength);
-        
-        // Cleanup.
-        delete[] ifbuff;
-        delete[] ofbuff;
-        remove(filename.c_str());
-        ifdecomp.close();
-        ofdecomp.close();
-        
         return true;
     }
     
@@ -9,38 +9,35 @@
 #ifndef FRAMEGEN_HPP_
 #define FRAMEGEN_HPP_
 
+#include <algorithm>
+#include <atomic>
 #include <bitset>
 #include <chrono>
+#include <cmath>
 #include <cstring>
 #include <ctime>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <random>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 #include "zlib.h"
 
-#define CRC32_POLYNOMIAL 3988292384
+#include "Checker.hpp"
+#include "Compress.hpp"
+#include "FileBatch.hpp"
+#include "Format.hpp"
+#include "Noise.hpp"
+#include "Signal.hpp"
+#include "Types.hpp"
 
 namespace framegen {
-typedef uint32_t word_t;
-typedef uint16_t adc_t;
-
-// Constants for general use.
-static const unsigned num_frame_hdr_words = 4;
-static const unsigned num_COLDATA_hdr_words = 4;
-static const unsigned num_frame_words = 117;
-static const unsigned num_frame_bytes = num_frame_words * 4;
-static const unsigned num_COLDATA_words = 28;
-
-static const unsigned num_ch_per_frame = 256;
-static const unsigned num_ch_per_block = 64;
-static const unsigned num_stream_per_block = 8;
-static const unsigned num_ch_per_stream = 8;
-
-const uint32_t getBitRange(const uint32_t& word, int begin, int end) {
+inline const uint32_t getBitRange(const uint32_t& word, int begin, int end) {
   if (begin == 0 && end == 31)
     return word;
   else
@@ -150,58 +147,16 @@ struct ColdataBlock {
   ColdataHeader head;
   word_t adcs[24];
 
+  // Positions come from the compile-time table of the WIB 1.0 layout (see
+  // Format.hpp).
   adc_t channel(const uint8_t& adc, const uint8_t& ch) const {
-    // All channel values are split in a first and second part. Because two
-    // streams are put side-by-side, the effective word size per stream is 16
-    // bits.
-    uint8_t first_word = (adc / 2) * 6 + 12 * ch / 16;
-    uint8_t first_offset = (12 * ch) % 16;
-
-    // The split is at 8 bits for even channels and at 4 for odd ones.
-    uint8_t split = 4 * (2 - ch % 2);
-
-    uint8_t second_word = first_word + (first_offset + split) / 16;
-    uint8_t second_offset = (first_offset + split) % 16;
-
-    // Move offsets 8-15 to 16-23.
-    first_offset += (first_offset / 8) * 8;
-    second_offset += (second_offset / 8) * 8;
-
-    // Left-shift odd streams by 8 bits.
-    first_offset += (adc % 2) * 8;
-    second_offset += (adc % 2) * 8;
-
-    return getBitRange(adcs[first_word], first_offset,
-                       first_offset + split - 1) |
-           getBitRange(adcs[second_word], second_offset,
-                       second_offset + 12 - split - 1)
-               << split;
+    return get_block_channel<WIB1Format>(adcs, adc * num_ch_per_stream + ch);
   }
 
   void set_channel(const uint8_t& adc, const uint8_t& ch,
                    const uint16_t& new_channel) {
-    // Copied from the channel() function.
-    uint8_t first_word = (adc / 2) * 6 + 12 * ch / 16;
-    uint8_t first_offset = (12 * ch) % 16;
-
-    // The split is at 8 bits for even channels and at 4 for odd ones.
-    uint8_t split = 4 * (2 - ch % 2);
-
-    uint8_t second_word = first_word + (first_offset + split) / 16;
-    uint8_t second_offset = (first_offset + split) % 16;
-
-    // Move offsets 8-15 to 16-23.
-    first_offset += (first_offset / 8) * 8;
-    second_offset += (second_offset / 8) * 8;
-
-    // Left-shift odd streams by 8 bits.
-    first_offset += (adc % 2) * 8;
-    second_offset += (adc % 2) * 8;
-
-    setBitRange(adcs[first_word], new_channel, first_offset,
-                first_offset + split - 1);
-    setBitRange(adcs[second_word], new_channel >> split, second_offset,
-                second_offset + 12 - split - 1);
+    set_block_channel<WIB1Format>(adcs, adc * num_ch_per_stream + ch,
+                                  new_channel);
   }
 
   void printADCs() const {
@@ -223,219 +178,398 @@ struct WIBFrame {
 };
 
 // ==================================================================
-// The main Frame class used to accept and give access to WIB frames.
+// Checksum calculations on the 117 words of a frame.
 // ==================================================================
-class Frame {
-  // Frame structure 1.0 from Daniel Gastler.
- private:
-  word_t _binaryData[num_frame_words];
-  WIBFrame* _frame = reinterpret_cast<WIBFrame*>(_binaryData);
+// Longitudinal redundancy check (16-bit).
+uint16_t calculate_checksum_a(const word_t* frame, unsigned int blockNum,
+                              uint16_t init = 0);
+// Modular checksum (16-bit).
+uint16_t calculate_checksum_b(const word_t* frame, unsigned int blockNum,
+                              uint16_t init = 0);
+// Cyclic redundancy check (32-bit).
+uint32_t calculate_CRC32(const word_t* frame, uint32_t padding = 0,
+                         uint32_t CRC32_Polynomial = CRC32_POLYNOMIAL);
+// Zlib's cyclic redundancy check (32-bit).
+uint32_t calculate_zCRC32(const word_t* frame, uint32_t padding = 0);
+// Recalculate both block checksums of all blocks and the CRC.
+void resetChecksums(word_t* frame);
+void clearReserved(word_t* frame);
 
- public:
-  adc_t channel(uint8_t block_num, uint8_t adc, uint8_t ch) const {
-    return _frame->block[block_num].channel(adc, ch);
+// ==================================================================
+// Accessors shared by Frame and the frame views. The derived class provides
+// data(), which points to the words of the frame. Fields and channels are
+// read through the layout policy Format (see Format.hpp), so every accessor
+// is specialised for that layout at compile time.
+// ==================================================================
+template <class Derived, class Format = DefaultFormat>
+class FrameAccess {
+ protected:
+  WIBFrame* wib() {
+    return reinterpret_cast<WIBFrame*>(static_cast<Derived*>(this)->data());
+  }
+  const WIBFrame* wib() const {
+    return reinterpret_cast<const WIBFrame*>(
+        static_cast<const Derived*>(this)->data());
+  }
+  word_t* words() { return static_cast<Derived*>(this)->data(); }
+  const word_t* words() const {
+    return static_cast<const Derived*>(this)->data();
   }
-  adc_t channel(uint8_t ch) const {
-    uint8_t block_num = ch / num_ch_per_block;
-    uint8_t adc_num = ch / num_ch_per_stream;
-    uint8_t ch_num = ch % num_ch_per_stream;
+  word_t get(const BitField f) const { return get_field(words(), f); }
+  void set(const BitField f, const word_t value) {
+    set_field(words(), f, value);
+  }
+  static BitField block(const uint8_t block_num, const BitField f) {
+    return Format::block_field(block_num, f);
+  }
+  // For the members that go through the WIB 1.0 structs or the checksum
+  // functions above, which know no other layout.
+  static constexpr bool is_wib1 = std::is_same<Format, WIB1Format>::value;
+
+ public:
+  typedef Format format;
 
-    return channel(block_num, adc_num, ch_num);
+  adc_t channel(uint8_t block_num, uint8_t adc, uint8_t ch) const {
+    return get_block_channel<Format>(words() + Format::adc_word(block_num),
+                                     adc * Format::num_ch_per_stream + ch);
   }
+  adc_t channel(uint8_t ch) const { return get_channel<Format>(words(), ch); }
 
   // WIB header accessors.
-  uint8_t sof() { return _frame->head.sof; }
-  uint8_t version() const { return _frame->head.version; }
-  uint8_t fiber_no() const { return _frame->head.fiber_no; }
-  uint8_t slot_no() const { return _frame->head.slot_no; }
-  uint8_t reserved_1() const { return _frame->head.reserved_1; }
-  uint8_t crate_no() const { return _frame->head.crate_no; }
-  uint8_t mm() const { return _frame->head.mm; }
-  uint8_t oos() const { return _frame->head.oos; }
-  uint16_t reserved_2() const { return _frame->head.reserved_2; }
-  uint16_t wib_errors() const { return _frame->head.wib_errors; }
-  uint64_t timestamp() const { return _frame->head.timestamp(); }
-  uint16_t wib_counter() const { return _frame->head.wib_counter; }
-  uint8_t z() const { return _frame->head.z; }
+  uint8_t sof() const { return get(Format::sof()); }
+  uint8_t version() const { return get(Format::version()); }
+  uint8_t fiber_no() const { return get(Format::fiber_no()); }
+  uint8_t slot_no() const { return get(Format::slot_no()); }
+  uint8_t reserved_1() const { return get(Format::reserved_1()); }
+  uint8_t crate_no() const { return get(Format::crate_no()); }
+  uint8_t mm() const { return get(Format::mm()); }
+  uint8_t oos() const { return get(Format::oos()); }
+  uint16_t reserved_2() const { return get(Format::reserved_2()); }
+  uint16_t wib_errors() const { return get(Format::wib_errors()); }
+  uint64_t timestamp() const { return Format::timestamp(words()); }
+  uint16_t wib_counter() const { return get(Format::wib_counter()); }
+  uint8_t z() const { return get(Format::z()); }
   // WIB header modifiers.
-  void set_sof(const uint8_t& newSof) { _frame->head.sof = newSof; }
+  void set_sof(const uint8_t& newSof) { set(Format::sof(), newSof); }
   void set_version(const uint8_t& newVersion) {
-    _frame->head.version = newVersion;
+    set(Format::version(), newVersion);
   }
   void set_fiber_no(const uint8_t& newFiber_no) {
-    _frame->head.fiber_no = newFiber_no;
+    set(Format::fiber_no(), newFiber_no);
   }
   void set_slot_no(const uint8_t& newSlot_no) {
-    _frame->head.slot_no = newSlot_no;
+    set(Format::slot_no(), newSlot_no);
   }
   void set_reserved_1(const uint8_t& newReserved_1) {
-    _frame->head.reserved_1 = newReserved_1;
+    set(Format::reserved_1(), newReserved_1);
   }
   void set_crate_no(const uint8_t& newCrate_no) {
-    _frame->head.crate_no = newCrate_no;
+    set(Format::crate_no(), newCrate_no);
   }
-  void set_mm(const uint8_t& newMm) { _frame->head.mm = newMm; }
-  void set_oos(const uint8_t& newOos) { _frame->head.oos = newOos; }
+  void set_mm(const uint8_t& newMm) { set(Format::mm(), newMm); }
+  void set_oos(const uint8_t& newOos) { set(Format::oos(), newOos); }
   void set_reserved_2(const uint8_t& newReserved_2) {
-    _frame->head.reserved_2 = newReserved_2;
+    set(Format::reserved_2(), newReserved_2);
   }
   void set_wib_errors(const uint16_t& newWib_errors) {
-    _frame->head.wib_errors = newWib_errors;
+    set(Format::wib_errors(), newWib_errors);
   }
   void set_timestamp(const uint64_t& newTimestamp) {
-    _frame->head.set_timestamp(newTimestamp);
+    Format::set_timestamp(words(), newTimestamp);
   }
   void set_wib_counter(const uint16_t& newWib_counter) {
-    _frame->head.wib_counter = newWib_counter;
+    set(Format::wib_counter(), newWib_counter);
   }
-  void set_z(const uint8_t& newZ) { _frame->head.z = newZ; }
+  void set_z(const uint8_t& newZ) { set(Format::z(), newZ); }
 
   // Coldata block accessors.
   uint8_t s1_error(const uint8_t& block_num) const {
-    return _frame->block[block_num].head.s1_error;
+    return get(block(block_num, Format::s1_error()));
   }
   uint8_t s2_error(const uint8_t& block_num) const {
-    return _frame->block[block_num].head.s2_error;
+    return get(block(block_num, Format::s2_error()));
   }
   uint8_t reserved_1(const uint8_t& block_num) const {
-    return _frame->block[block_num].head.reserved_1;
+    return get(block(block_num, Format::block_reserved_1()));
   }
   uint16_t checksum_a(const uint8_t& block_num) const {
-    return _frame->block[block_num].head.checksum_a();
+    return Format::checksum_a(words(), block_num);
   }
   uint16_t checksum_b(const uint8_t& block_num) const {
-    return _frame->block[block_num].head.checksum_b();
+    return Format::checksum_b(words(), block_num);
   }
   uint16_t coldata_convert_count(const uint8_t& block_num) const {
-    return _frame->block[block_num].head.coldata_convert_count;
+    return get(block(block_num, Format::coldata_convert_count()));
   }
   uint16_t error_register(const uint8_t& block_num) const {
-    return _frame->block[block_num].head.error_register;
+    return get(block(block_num, Format::error_register()));
   }
   uint16_t reserved_2(const uint8_t& block_num) const {
-    return _frame->block[block_num].head.reserved_2;
+    return get(block(block_num, Format::block_reserved_2()));
   }
   uint8_t HDR(const uint8_t& block_num, const uint8_t& HDR_num) const {
-    return _frame->block[block_num].head.HDR(HDR_num);
-  }
-  uint16_t channel(const uint8_t& block_num, const uint8_t& adc,
-                   const uint8_t& ch) {
-    return _frame->block[block_num].channel(adc, ch);
-  }
-  uint16_t channel(const uint8_t& ch) {
-    return channel(ch / num_ch_per_block,
-                   (ch % num_ch_per_block) / num_ch_per_stream,
-                   ch % num_ch_per_stream);
+    return get(block(block_num, Format::hdr())) >> (HDR_num % 8) * 4 & 0xF;
   }
   // This is a terrible function. Only currently in use for frame conversion.
   word_t* adcs(const uint8_t& block_num) {
-    return &_binaryData[num_frame_hdr_words + block_num * num_COLDATA_words +
-                        num_COLDATA_hdr_words];
+    return words() + Format::adc_word(block_num);
+  }
+  const word_t* adcs(const uint8_t& block_num) const {
+    return words() + Format::adc_word(block_num);
   }
   // Coldata block modifiers.
   void set_s1_error(const uint8_t& block_num, const uint8_t& new_s1_error) {
-    _frame->block[block_num].head.s1_error = new_s1_error;
+    set(block(block_num, Format::s1_error()), new_s1_error);
   }
   void set_s2_error(const uint8_t& block_num, const uint8_t& new_s2_error) {
-    _frame->block[block_num].head.s2_error = new_s2_error;
+    set(block(block_num, Format::s2_error()), new_s2_error);
   }
   void set_reserved_1(const uint8_t& block_num, const uint8_t& new_reserved_1) {
-    _frame->block[block_num].head.reserved_1 = new_reserved_1;
+    set(block(block_num, Format::block_reserved_1()), new_reserved_1);
   }
   void set_checksum_a(const uint8_t& block_num,
                       const uint16_t& new_checksum_a) {
-    _frame->block[block_num].head.set_checksum_a(new_checksum_a);
+    set(block(block_num, Format::checksum_a_1()), new_checksum_a);
+    set(block(block_num, Format::checksum_a_2()), new_checksum_a >> 8);
   }
   void set_checksum_b(const uint8_t& block_num,
                       const uint16_t& new_checksum_b) {
-    _frame->block[block_num].head.set_checksum_b(new_checksum_b);
+    set(block(block_num, Format::checksum_b_1()), new_checksum_b);
+    set(block(block_num, Format::checksum_b_2()), new_checksum_b >> 8);
   }
   void set_coldata_convert_count(const uint8_t& block_num,
                                  const uint16_t& new_coldata_convert_count) {
-    _frame->block[block_num].head.coldata_convert_count =
-        new_coldata_convert_count;
+    set(block(block_num, Format::coldata_convert_count()),
+        new_coldata_convert_count);
   }
   void set_error_register(const uint8_t& block_num,
                           const uint16_t& new_error_register) {
-    _frame->block[block_num].head.error_register = new_error_register;
+    set(block(block_num, Format::error_register()), new_error_register);
   }
   void set_reserved_2(const uint8_t& block_num,
                       const uint16_t& new_reserved_2) {
-    _frame->block[block_num].head.reserved_2 = new_reserved_2;
+    set(block(block_num, Format::block_reserved_2()), new_reserved_2);
   }
   void set_HDR(const uint8_t& block_num, const uint8_t& HDR_num,
                const uint16_t& new_hdr) {
-    _frame->block[block_num].head.set_HDR(HDR_num, new_hdr);
+    const unsigned shift = (HDR_num % 8) * 4;
+    const BitField hdr = block(block_num, Format::hdr());
+    set(hdr, (get(hdr) & ~(0xFu << shift)) | (new_hdr & 0xFu) << shift);
   }
   void set_channel(const uint8_t& block_num, const uint8_t& adc,
                    const uint8_t& ch, const uint16_t& new_channel) {
-    _frame->block[block_num].set_channel(adc, ch, new_channel);
+    set_block_channel<Format>(words() + Format::adc_word(block_num),
+                              adc * Format::num_ch_per_stream + ch,
+                              new_channel);
   }
   void set_channel(const uint8_t& ch, const uint16_t& new_channel) {
-    set_channel(ch / num_ch_per_block,
-                (ch % num_ch_per_block) / num_ch_per_stream,
-                ch % num_ch_per_stream, new_channel);
+    framegen::set_channel<Format>(words(), ch, new_channel);
   }
 
-  uint32_t CRC32() { return _frame->CRC32; }
-  void set_CRC32(uint32_t newCRC32) { _frame->CRC32 = newCRC32; }
+  uint32_t CRC32() const { return words()[Format::crc_word]; }
+  void set_CRC32(uint32_t newCRC32) { words()[Format::crc_word] = newCRC32; }
 
+  // The members below work on the WIB 1.0 structures and only compile for
+  // that layout.
   void print() const {
-    _frame->head.printHex();
+    static_assert(is_wib1, "print() needs the WIB 1.0 layout.");
+    wib()->head.printHex();
     for (unsigned i = 0; i < 4; ++i) {
       std::cout << "Coldata block " << i << ":\n";
-      //_frame->block[i].head.printHex();
-      _frame->block[i].printADCs();
+      // wib()->block[i].head.printHex();
+      wib()->block[i].printADCs();
     }
   }
 
   // Struct mutators.
-  void setWIBHeader(WIBHeader newWIBHeader) { _frame->head = newWIBHeader; }
+  void setWIBHeader(WIBHeader newWIBHeader) {
+    static_assert(is_wib1, "setWIBHeader() needs the WIB 1.0 layout.");
+    wib()->head = newWIBHeader;
+  }
   void setColdataBlock(unsigned int blockNum, ColdataBlock newColdataBlock) {
-    _frame->block[blockNum] = newColdataBlock;
+    static_assert(is_wib1, "setColdataBlock() needs the WIB 1.0 layout.");
+    wib()->block[blockNum] = newColdataBlock;
   }
 
-  bool load(std::string filename, int frameNum = 0);
-  void load(std::ifstream& strm, int frameNum = 0);
-  void load(uint8_t* begin);
-
   // Utility functions.
-  void resetChecksums();
-  void clearReserved();
+  void resetChecksums() {
+    static_assert(is_wib1, "resetChecksums() needs the WIB 1.0 layout.");
+    framegen::resetChecksums(words());
+  }
+  void clearReserved() {
+    static_assert(is_wib1, "clearReserved() needs the WIB 1.0 layout.");
+    framegen::clearReserved(words());
+  }
 
-  // Longitudinal redundancy check (8-bit).
-  uint16_t calculate_checksum_a(unsigned int blockNum, uint16_t init = 0);
-  // Modular checksum (8-bit).
-  uint16_t calculate_checksum_b(unsigned int blockNum, uint16_t init = 0);
+  // Longitudinal redundancy check (16-bit).
+  uint16_t calculate_checksum_a(unsigned int blockNum,
+                                uint16_t init = 0) const {
+    static_assert(is_wib1, "Checksum A needs the WIB 1.0 layout.");
+    return framegen::calculate_checksum_a(words(), blockNum, init);
+  }
+  // Modular checksum (16-bit).
+  uint16_t calculate_checksum_b(unsigned int blockNum,
+                                uint16_t init = 0) const {
+    static_assert(is_wib1, "Checksum B needs the WIB 1.0 layout.");
+    return framegen::calculate_checksum_b(words(), blockNum, init);
+  }
   // Cyclic redundancy check (32-bit).
   uint32_t calculate_CRC32(uint32_t padding = 0,
-                           uint32_t CRC32_Polynomial = CRC32_POLYNOMIAL);
+                           uint32_t CRC32_Polynomial = CRC32_POLYNOMIAL) const {
+    static_assert(is_wib1, "The CRC needs the WIB 1.0 layout.");
+    return framegen::calculate_CRC32(words(), padding, CRC32_Polynomial);
+  }
   // Zlib's cyclic redundancy check (32-bit).
-  uint32_t calculate_zCRC32(uint32_t padding = 0);
+  uint32_t calculate_zCRC32(uint32_t padding = 0) const {
+    static_assert(is_wib1, "The CRC needs the WIB 1.0 layout.");
+    return framegen::calculate_zCRC32(words(), padding);
+  }
+};
+
+template <class Format>
+class BasicConstFrameView;
+class FrameFile;
+class FrameRing;
+class FrameWriter;
+
+// ==================================================================
+// The main Frame class used to accept and give access to WIB frames.
+// ==================================================================
+// A frame is a plain, trivially copyable block of Format::num_words words, so
+// arrays of frames have exactly the layout of a frame file and can be copied
+// with memcpy. Frame is the WIB 1.0 frame that the rest of FrameGen works
+// with; the loading and printing members are only instantiated for it.
+template <class Format>
+class BasicFrame : public FrameAccess<BasicFrame<Format>, Format> {
+ private:
+  word_t _binaryData[Format::num_words];
+
+ public:
+  word_t* data() { return _binaryData; }
+  const word_t* data() const { return _binaryData; }
+
+  bool load(std::string filename, int frameNum = 0);
+  bool load(const FrameFile& file, size_t frameNum);
+  void load(std::ifstream& strm, int frameNum = 0);
+  void load(uint8_t* begin);
+  void load(const BasicConstFrameView<Format>& view);
 
-  // Overloaded and friended frame print functions.
+  // Overloaded frame print functions.
+  using FrameAccess<BasicFrame<Format>, Format>::print;
   bool print(std::string filename, char opt = 'b');
   bool print(std::ofstream& strm, char opt = 'b');
-  friend bool print(const Frame& frame, std::string filename, char opt,
-                    const int Nframes);
-  friend bool print(const Frame& frame, std::ofstream& strm, char opt,
-                    const int Nframes);
-};  // class Frame
+  bool print(FrameWriter& writer);
+};  // class BasicFrame
+
+typedef BasicFrame<WIB1Format> Frame;
+
+static_assert(sizeof(Frame) == num_frame_bytes,
+              "Frame must have exactly the size of a WIB frame.");
+static_assert(std::is_trivially_copyable<Frame>::value,
+              "Frame must be trivially copyable.");
+
+// ==================================================================
+// Non-owning views of a frame in memory that is owned elsewhere, such as a
+// mapped file, a DMA buffer or a ring slot. The memory must be 4-byte aligned
+// and Format::num_words words long. Views have the same accessors as frames
+// of their layout; a const view only compiles the non-modifying ones.
+// ==================================================================
+template <class Format>
+class BasicConstFrameView
+    : public FrameAccess<BasicConstFrameView<Format>, Format> {
+ private:
+  const word_t* _data;
+
+ public:
+  explicit BasicConstFrameView(const word_t* data) : _data(data) {}
+  explicit BasicConstFrameView(const void* bytes)
+      : _data(static_cast<const word_t*>(bytes)) {}
+  BasicConstFrameView(const BasicFrame<Format>& frame)
+      : _data(frame.data()) {}
+
+  const word_t* data() const { return _data; }
+};
+
+template <class Format>
+class BasicFrameView : public FrameAccess<BasicFrameView<Format>, Format> {
+ private:
+  word_t* _data;
+
+ public:
+  explicit BasicFrameView(word_t* data) : _data(data) {}
+  explicit BasicFrameView(void* bytes) : _data(static_cast<word_t*>(bytes)) {}
+  BasicFrameView(BasicFrame<Format>& frame) : _data(frame.data()) {}
+
+  word_t* data() const { return _data; }
+  operator BasicConstFrameView<Format>() const {
+    return BasicConstFrameView<Format>(_data);
+  }
+};
+
+typedef BasicConstFrameView<WIB1Format> ConstFrameView;
+typedef BasicFrameView<WIB1Format> FrameView;
 
 // Function to check whether a frame corresponds to its checksums.
 const bool check(const std::string& filename);
-// Function to check frames within a single file.
+// Function to check frames within a single file. All frames are checked in
+// parallel; use checkFile() (Checker.hpp) for a structured report.
 const bool checkSingleFile(const std::string& filename);
 
 // Functions to compress and decompress frames or sets of frames by a file name.
+// compressFile() replaces the file by a chunked ".comp" container; see
+// Compress.hpp for the format and Compressor.hpp for the backends.
 const bool compressFile(const std::string& filename);
-const bool decompressFile(const std::string& filename);
+const bool compressFile(const std::string& filename,
+                        const CompressOptions& options,
+                        CompressorStats* stats = nullptr);
+const bool decompressFile(const std::string& filename,
+                          CompressorStats* stats = nullptr);
 
 // Frame print functions.
 bool print(const Frame& frame, std::string filename, char opt = 'b',
            const int Nframes = 1);
 bool print(const Frame& frame, std::ofstream& strm, char opt = 'b',
            const int Nframes = 1);
+// Binary only; the writer buffers and batches the frames.
+bool print(const Frame& frame, FrameWriter& writer);
+
+// Identity of a link: the WIB it comes from and its fiber on that WIB.
+struct LinkId {
+  uint8_t crate = 0;
+  uint8_t slot = 0;
+  uint8_t fiber = 0;
+
+  LinkId() {}
+  LinkId(uint8_t crate_no, uint8_t slot_no, uint8_t fiber_no)
+      : crate(crate_no), slot(slot_no), fiber(fiber_no) {}
+};
+
+// =============================================================
+// Source of frame timestamps. Generators claim ranges of consecutive
+// timestamps, frame_timestamp_step apart, atomically, so generators sharing
+// a clock never hand out the same timestamp twice. Generators with separate
+// clocks started at the same time stay synchronized, as links driven by one
+// timing system do.
+// =============================================================
+class TimestampClock {
+ private:
+  std::atomic<uint64_t> _next;
+
+ public:
+  // Starts at the current system time in ns.
+  TimestampClock();
+  explicit TimestampClock(uint64_t start) : _next(start) {}
+
+  // First of Nframes consecutive timestamps.
+  uint64_t claim(unsigned long Nframes) {
+    return _next.fetch_add(frame_timestamp_step * Nframes);
+  }
+  uint64_t next() const { return _next; }
+  void reset(uint64_t start) { _next = start; }
+
+  // The clock all generators use unless given another one.
+  static TimestampClock& shared();
+};
 
 // =============================================================
 // A generator class to generate frames in an automated fashion.
@@ -459,19 +593,52 @@ class FrameGen {
   uint16_t _noisePedestal = 250;  // Pedestal of the noise (0 - 2^10).
   uint16_t _noiseAmplitude = 10;  // Amplitude of the noise (0 - 2^10).
 
-  // Random double generator to set error bits and generate noise.
+  // Noise generator, also used to set error bits.
   std::random_device _rd;
-  std::mt19937 _mt;
-  std::uniform_real_distribution<double> _randDouble;
+  NoiseGen _noise;
+
+  // Pulses overlaid on the noise, off unless enabled with setSignal().
+  SignalGen _signal;
+
+  // Timestamp source, and the fixed link identity if one is set.
+  TimestampClock* _clock = &TimestampClock::shared();
+  bool _hasLink = false;
+  LinkId _link;
+
+  // Number of threads used by generateSingleFile().
+  unsigned _threads = 1;
+
+  // Open binary output files with O_DIRECT.
+  bool _directIO = false;
+
+  // How generate() writes its files, and how fast the last call did.
+  FileBatchOptions _fileBatch;
+  FileBatchStats _fileBatchStats;
+
+  // Backend for compressFile() and statistics of the last (de)compression.
+  CompressOptions _compression;
+  CompressorStats _compressionStats;
 
   void fill();
+  void fill(Frame& frame, NoiseGen& noise, SignalGen* signal,
+            const uint64_t timestamp, const uint64_t frameNo) const;
+  SignalGen* signal() {
+    return _signal.options().enabled() ? &_signal : nullptr;
+  }
+  // Signal generators for worker threads, with the seed of the main one.
+  std::vector<SignalGen> workerSignals(unsigned threads) const;
+  void initNoise();
+  // Returns false as soon as a write fails; the workers stop at their next
+  // batch.
+  bool generateParallel(
+      const std::function<bool(const Frame*, unsigned long)>& write,
+      const unsigned long Nframes);
 
  public:
   // Constructors/destructors.
-  FrameGen() : _mt(_rd()), _randDouble(0.0, 1.0) {}
-  FrameGen(const std::string& prefix)
-      : _prefix(prefix), _mt(_rd()), _randDouble(0.0, 1.0) {}
-  FrameGen(const int maxNoise) : _noiseAmplitude(maxNoise) {}
+  FrameGen() { initNoise(); }
+  FrameGen(const std::string& prefix) : _prefix(prefix) { initNoise(); }
+  FrameGen(const int maxNoise) : _noiseAmplitude(maxNoise) { initNoise(); }
   ~FrameGen() {}
 
   // Frame name accessors/modifiers.
@@ -485,17 +652,86 @@ class FrameGen {
   const std::string& getExtension() { return _extension; }
 
   const std::string getFileName(unsigned long i) {
-    return _path + _prefix + std::to_string(i) + _suffix + _extension;
+    return _path + _fileBatch.shardDirectory(i) + _prefix + std::to_string(i) +
+           _suffix + _extension;
   }
   const std::string getFileName() {
     return _path + _prefix + _suffix + _extension;
   }
 
-  // Noise parameter accessors/modifiers.
-  void setPedestal(uint16_t pedestal) { _noisePedestal = pedestal; }
+  // Noise parameter accessors/modifiers. The flat setters overwrite any
+  // per-channel map; the amplitude gives the same RMS as binomial noise of
+  // that amplitude, sqrt(amplitude/2).
+  void setPedestal(uint16_t pedestal) {
+    _noisePedestal = pedestal;
+    _noise.setPedestal(pedestal);
+  }
   const uint16_t getPedestal() { return _noisePedestal; }
-  void setAmplitude(uint16_t amplitude) { _noiseAmplitude = amplitude; }
+  void setAmplitude(uint16_t amplitude) {
+    _noiseAmplitude = amplitude;
+    _noise.setRMS(std::sqrt(amplitude / 2.0));
+  }
   const uint16_t getAmplitude() { return _noiseAmplitude; }
+  // Chance for each error bit (WIB, S1 and S2 of every block) to be set.
+  void setErrorProbability(double probability) { _errProb = probability; }
+  const double getErrorProbability() { return _errProb; }
+  // Per-channel noise maps (num_ch_per_frame entries, ordered as
+  // Frame::channel(ch)).
+  bool setPedestalMap(const std::vector<float>& pedestals) {
+    return _noise.setPedestalMap(pedestals);
+  }
+  bool setRMSMap(const std::vector<float>& rms) {
+    return _noise.setRMSMap(rms);
+  }
+  NoiseGen& noise() { return _noise; }
+
+  // Signal injection: pulse templates added to the noise of selected
+  // channels, at rates set per event type (see Signal.hpp). The events are
+  // seeded from noise(), so seed that first for reproducible signal.
+  void setSignal(const SignalOptions& options) {
+    _signal.setOptions(options);
+    _signal.seed(_noise.next());
+  }
+  const SignalOptions& getSignal() const { return _signal.options(); }
+  // Counts of the main stream only; worker threads have their own.
+  const SignalGen::Stats& signalStats() const { return _signal.stats(); }
+
+  // Link identity written into every frame. Without one, crate, slot and
+  // fiber numbers are drawn at random for each frame.
+  void setLink(const LinkId& link) {
+    _link = link;
+    _hasLink = true;
+  }
+  void clearLink() { _hasLink = false; }
+  bool hasLink() const { return _hasLink; }
+  const LinkId& getLink() const { return _link; }
+
+  // Timestamp source. The clock must outlive the generator.
+  void setClock(TimestampClock& clock) { _clock = &clock; }
+  TimestampClock& clock() { return *_clock; }
+
+  // Number of worker threads for generateSingleFile(). Each worker draws from
+  // its own noise stream, seeded from noise(); frames are still written in
+  // timestamp order. Zero selects one thread per hardware core.
+  void setThreads(unsigned threads) {
+    _threads = threads ? threads
+                       : std::max(1u, std::thread::hardware_concurrency());
+  }
+  const unsigned getThreads() { return _threads; }
+
+  // Write binary output with direct I/O, bypassing the page cache. Only used
+  // where the file system supports it, and not for the single-frame files of
+  // generate(), which are smaller than a block.
+  void setDirectIO(bool direct) { _directIO = direct; }
+  const bool getDirectIO() { return _directIO; }
+
+  // Back end, queue depth and sharding of the files written by generate()
+  // (see FileBatch.hpp). With sharding, file i is in the subdirectory
+  // i/shardFiles of the path; the subdirectories are created as needed.
+  void setFileBatch(const FileBatchOptions& options) { _fileBatch = options; }
+  const FileBatchOptions& getFileBatch() const { return _fileBatch; }
+  // Files, bytes, time and back end of the last generate().
+  const FileBatchStats& fileBatchStats() const { return _fileBatchStats; }
 
   // Main generator function: builds frames and calls the fill function.
   void generate(const unsigned long Nframes = 1, char opt = 'b');
@@ -508,6 +744,19 @@ class FrameGen {
   void generateSingleFile(const std::string& newPrefix,
                           const unsigned long Nframes = 1, char opt = 'b');
 
+  // Fill frames straight into the slots of a ring, in batches of up to
+  // batchFrames, waiting while it is full. Several generators can feed a
+  // multi-producer ring from their own threads; each batch then has
+  // consecutive timestamps, but batches of different generators interleave.
+  // Returns false if the ring is closed first.
+  bool generate(FrameRing& ring, const unsigned long Nframes,
+                const size_t batchFrames = 256);
+
+  // Generate frames in memory, split across the worker threads. The worker
+  // noise streams are seeded from this generator's, so seeding noise() makes
+  // the ADC data reproducible.
+  void generateBuffer(std::vector<Frame>& frames, const unsigned long Nframes);
+
   // Function that attempts to open a file by its name, trying variations with
   // class parameters (_extension, _path, etc.).
   const bool openFile(std::ifstream& strm, const std::string& filename);
@@ -515,18 +764,48 @@ class FrameGen {
   // Overloaded and ranged check functions that absolutely require the FrameGen
   // filename parameters.
   const bool check() {
-    return framegen::check(_path + _prefix + "0" + _suffix + _extension);
+    return framegen::check(getFileName(0));
   }
   const bool check(const unsigned int begin, const unsigned int end);
   const bool check(const unsigned int end) { return check(0, end); }
   const bool checkSingleFile() {
     return framegen::checkSingleFile(getFileName());
   }
+  // Structured, console-free variants of the above.
+  CheckReport checkReport(const unsigned int begin, const unsigned int end,
+                          const CheckOptions& options = CheckOptions());
+  CheckReport checkReport(const CheckOptions& options = CheckOptions()) {
+    return checkFile(getFileName(), options);
+  }
+
+  // Compression backend by registered name ("store", "zlib", "wib", and
+  // "lz4"/"zstd" when built with them). Returns false for unknown names.
+  bool setCompression(const std::string& name,
+                      const int level = use_default_level) {
+    CompressorInfo info;
+    if (!findCompressor(name, info)) {
+      std::cout << "Error (setCompression()): no compressor named " << name
+                << "." << std::endl;
+      return false;
+    }
+    _compression.compressor = name;
+    _compression.level = level;
+    return true;
+  }
+  void setCompression(const CompressOptions& options) {
+    _compression = options;
+  }
+  const CompressOptions& getCompression() { return _compression; }
+  // Bytes in/out and time of the last compressFile()/decompressFile().
+  const CompressorStats& compressionStats() { return _compressionStats; }
 
   // Overloaded compression/decompression functions.
-  const bool compressFile() { return framegen::compressFile(getFileName()); }
+  const bool compressFile() {
+    return framegen::compressFile(getFileName(), _compression,
+                                  &_compressionStats);
+  }
   const bool decompressFile() {
-    return framegen::decompressFile(getFileName());
+    return framegen::decompressFile(getFileName(), &_compressionStats);
   }
 
   // Overloaded frame print functions.
@@ -539,6 +818,7 @@ class FrameGen {
   bool print(std::ofstream& strm, char opt = 'b') {
     return framegen::print(_frame, strm, opt);
   }
+  bool print(FrameWriter& writer) { return framegen::print(_frame, writer); }
 };
 
 }  // namespace framegen
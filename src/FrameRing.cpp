@@ -0,0 +1,129 @@
+//============================================================================
+// Name        : FrameRing.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Lock-free ring buffer of frames between threads.
+//============================================================================
+
+#include "src/FrameRing.hpp"
+#include "src/Cpu.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+namespace framegen {
+
+    namespace {
+        // Spin briefly, then give the core away; producers and consumers may share one.
+        inline void backoff(unsigned& spins) {
+            if(++spins < 64)
+                cpu::relax();
+            else
+                std::this_thread::yield();
+        }
+    } // namespace
+
+    FrameRing::FrameRing(const size_t capacity, const Mode mode) : _mode(mode), _closed(false) {
+        _capacity = 1;
+        while(_capacity < capacity)
+            _capacity <<= 1;
+        void* slots = nullptr;
+        if(posix_memalign(&slots, 4096, _capacity*sizeof(Frame))) {
+            std::cout << "Error (FrameRing()): could not allocate " << _capacity << " slots." << std::endl;
+            // A ring without slots starts out closed, so neither side waits on it.
+            _capacity = 0;
+            slots = nullptr;
+            _closed = true;
+        }
+        _slots = static_cast<Frame*>(slots);
+    }
+
+    FrameRing::~FrameRing() { free(_slots); }
+
+    //===========
+    // Producers
+    //===========
+    FrameRing::Batch FrameRing::claim(const size_t max) {
+        Batch batch;
+        uint64_t head = _head.value.load(std::memory_order_relaxed);
+        while(true) {
+            // A single producer only looks at the consumer's cursor when its cached copy shows too little room.
+            uint64_t tail;
+            if(_mode == multi_producer)
+                tail = _tail.value.load(std::memory_order_acquire);
+            else if(_capacity - (head - (tail = _head.cache)) < max)
+                tail = _head.cache = _tail.value.load(std::memory_order_acquire);
+            const size_t n = std::min(std::min<uint64_t>(max, _capacity - (head - tail)), _capacity - (head & (_capacity-1)));
+            if(!n)
+                return batch;
+            if(_mode == single_producer) {
+                _head.value.store(head + n, std::memory_order_relaxed);
+            } else if(!_head.value.compare_exchange_weak(head, head + n, std::memory_order_relaxed)) {
+                continue;
+            }
+            batch.frames = _slots + (head & (_capacity-1));
+            batch.count = n;
+            batch.position = head;
+            return batch;
+        }
+    }
+
+    FrameRing::Batch FrameRing::claimWait(const size_t max) {
+        unsigned spins = 0;
+        Batch batch = claim(max);
+        while(!batch.count && max && _capacity && !_closed) {
+            backoff(spins);
+            batch = claim(max);
+        }
+        return batch;
+    }
+
+    void FrameRing::publish(const Batch& batch) {
+        if(_mode == multi_producer) {
+            // Earlier claims must be published first.
+            unsigned spins = 0;
+            while(_published.value.load(std::memory_order_acquire) != batch.position)
+                backoff(spins);
+        }
+        _published.value.store(batch.position + batch.count, std::memory_order_release);
+    }
+
+    //==========
+    // Consumer
+    //==========
+    FrameRing::Batch FrameRing::peek(const size_t max) {
+        Batch batch;
+        const uint64_t tail = _tail.value.load(std::memory_order_relaxed);
+        if(_tail.cache - tail < max)
+            _tail.cache = _published.value.load(std::memory_order_acquire);
+        const size_t n = std::min(std::min<uint64_t>(max, _tail.cache - tail), _capacity - (tail & (_capacity-1)));
+        if(n) {
+            batch.frames = _slots + (tail & (_capacity-1));
+            batch.count = n;
+            batch.position = tail;
+        }
+        return batch;
+    }
+
+    FrameRing::Batch FrameRing::peekWait(const size_t max) {
+        unsigned spins = 0;
+        Batch batch = peek(max);
+        while(!batch.count && max) {
+            // Check for closing before looking again, so frames published just before close() are not lost.
+            const bool closed = _closed;
+            batch = peek(max);
+            if(batch.count || closed)
+                break;
+            backoff(spins);
+        }
+        return batch;
+    }
+
+    void FrameRing::release(const Batch& batch) {
+        _tail.value.store(batch.position + batch.count, std::memory_order_release);
+    }
+
+} // namespace framegen
@@ -0,0 +1,90 @@
+//==========================================================================
+// Name        : FrameRing.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Lock-free ring buffer of frames between threads.
+//============================================================================
+
+#ifndef FRAMEGEN_FRAMERING_HPP_
+#define FRAMEGEN_FRAMERING_HPP_
+
+#include <atomic>
+#include <cstddef>
+
+#include "FrameGen.hpp"
+
+namespace framegen {
+
+// ==================================================================
+// A bounded queue of frames for one consumer and either one or several
+// producers. Frames are written and read in place: a producer claims a batch
+// of free slots, fills them and publishes them; the consumer peeks at a batch
+// of published slots, uses them and releases them. Neither side copies or
+// locks. Batches are contiguous, so they never cross the end of the ring and
+// may be shorter than asked for.
+//
+// Slots are packed frames (num_frame_bytes apart) so a batch can go straight
+// to a FrameWriter; the cursors each sit on their own cache line. With several
+// producers, batches are published in the order they were claimed.
+// ==================================================================
+class FrameRing {
+ public:
+  enum Mode { single_producer, multi_producer };
+
+  struct Batch {
+    Frame* frames = nullptr;
+    size_t count = 0;
+    uint64_t position = 0;  // Ring position of the first frame.
+  };
+
+ private:
+  struct alignas(64) Cursor {
+    std::atomic<uint64_t> value;
+    uint64_t cache;  // The other side's cursor as last seen.
+    Cursor() : value(0), cache(0) {}
+  };
+
+  Frame* _slots = nullptr;
+  size_t _capacity = 0;
+  Mode _mode;
+  Cursor _head;       // Claimed by producers.
+  Cursor _published;  // Visible to the consumer.
+  Cursor _tail;       // Released by the consumer.
+  std::atomic<bool> _closed;
+
+ public:
+  // The capacity is rounded up to a power of two. If the slots cannot be
+  // allocated the ring is invalid and closed, so claimWait() and peekWait()
+  // return empty batches.
+  explicit FrameRing(size_t capacity, Mode mode = single_producer);
+  ~FrameRing();
+  FrameRing(const FrameRing&) = delete;
+  FrameRing& operator=(const FrameRing&) = delete;
+
+  bool valid() const { return _slots != nullptr; }
+  size_t capacity() const { return _capacity; }
+  Mode mode() const { return _mode; }
+  // Published frames not yet released. Only a snapshot.
+  size_t size() const { return _published.value.load() - _tail.value.load(); }
+
+  // Producer side. claim() returns an empty batch if the ring is full;
+  // claimWait() spins until there is room or the ring is closed.
+  Batch claim(size_t max);
+  Batch claimWait(size_t max);
+  void publish(const Batch& batch);
+
+  // Consumer side. peekWait() returns an empty batch only once the ring has
+  // been closed and drained.
+  Batch peek(size_t max);
+  Batch peekWait(size_t max);
+  void release(const Batch& batch);
+
+  // No more frames will be published; wakes a waiting consumer.
+  void close() { _closed = true; }
+  bool closed() const { return _closed; }
+};
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_FRAMERING_HPP_ */
@@ -0,0 +1,219 @@
+//============================================================================
+// Name        : FrameWriter.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Buffered binary sink for files of consecutive frames.
+//============================================================================
+
+#include "src/FrameWriter.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FRAMEGEN_POSIX 1
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace framegen {
+
+    // std::max() takes it by reference.
+    const size_t FrameWriter::alignment;
+
+    FrameWriter::~FrameWriter() {
+        close();
+        free(_buffer);
+    }
+
+    bool FrameWriter::allocate() {
+        const size_t capacity = std::max(alignment, (_bufferBytes+alignment-1) / alignment * alignment);
+        if(_buffer && capacity == _capacity)
+            return true;
+        free(_buffer);
+        _buffer = nullptr;
+        _capacity = 0;
+#ifdef FRAMEGEN_POSIX
+        void* p = nullptr;
+        if(posix_memalign(&p, alignment, capacity))
+            p = nullptr;
+#else
+        void* p = malloc(capacity);
+#endif
+        if(!p) {
+            std::cout << "Error (FrameWriter::open()): could not allocate a " << capacity << " byte buffer." << std::endl;
+            return false;
+        }
+        _buffer = static_cast<char*>(p);
+        _capacity = capacity;
+        return true;
+    }
+
+    bool FrameWriter::open(const std::string& filename, bool append) {
+        close();
+        _filename = filename;
+        _fill = 0;
+        _written = 0;
+        _offset = 0;
+        _failed = false;
+        if(!allocate())
+            return false;
+#ifdef FRAMEGEN_POSIX
+        const int flags = O_WRONLY | O_CREAT | (append? O_APPEND: O_TRUNC);
+        _direct = false;
+#ifdef O_DIRECT
+        if(_wantDirect) {
+            _fd = ::open(filename.c_str(), flags | O_DIRECT, 0644);
+            _direct = _fd >= 0;
+        }
+#endif
+        if(_fd < 0)
+            _fd = ::open(filename.c_str(), flags, 0644);
+        if(_fd < 0) {
+            std::cout << "Error (FrameWriter::open()): file " << filename << " could not be opened." << std::endl;
+            return false;
+        }
+        struct stat st;
+        if(append && !fstat(_fd, &st))
+            _offset = st.st_size;
+#ifdef O_DIRECT
+        // Direct writes have to start on a block boundary.
+        if(_direct && _offset%alignment) {
+            fcntl(_fd, F_SETFL, fcntl(_fd, F_GETFL) & ~O_DIRECT);
+            _direct = false;
+        }
+#endif
+#if defined(__linux__)
+        if(_preallocate)
+            fallocate(_fd, FALLOC_FL_KEEP_SIZE, _offset, _preallocate);
+#endif
+#else
+        _stream.open(filename, std::ios::binary | (append? std::ios::app: std::ios::trunc));
+        if(!_stream) {
+            std::cout << "Error (FrameWriter::open()): file " << filename << " could not be opened." << std::endl;
+            return false;
+        }
+#endif
+        return true;
+    }
+
+    // Write a and then b, as one system call where possible.
+    bool FrameWriter::writeOut(const char* a, size_t na, const char* b, size_t nb) {
+        if(_failed)
+            return false;
+#ifdef FRAMEGEN_POSIX
+        struct iovec iov[2];
+        iov[0].iov_base = const_cast<char*>(a);
+        iov[0].iov_len = na;
+        iov[1].iov_base = const_cast<char*>(b);
+        iov[1].iov_len = nb;
+        struct iovec* v = na? iov: iov+1;
+        int nv = na? 2: 1;
+        while(nv) {
+            const ssize_t n = ::writev(_fd, v, nv);
+            if(n < 0 && errno == EINTR)
+                continue;
+            if(n <= 0) {
+                std::cout << "Error (FrameWriter::write()): could not write to " << _filename << ": " << strerror(errno) << "." << std::endl;
+                _failed = true;
+                return false;
+            }
+            // Skip what was written.
+            size_t done = n;
+            while(nv && done >= v->iov_len) {
+                done -= v->iov_len;
+                v++;
+                nv--;
+            }
+            if(nv) {
+                v->iov_base = static_cast<char*>(v->iov_base) + done;
+                v->iov_len -= done;
+            }
+        }
+        return true;
+#else
+        _stream.write(a, na);
+        _stream.write(b, nb);
+        _failed = !_stream;
+        return !_failed;
+#endif
+    }
+
+    // Write the first bytes of the buffer and move the rest to the front.
+    bool FrameWriter::flushBuffer(size_t bytes) {
+        if(!writeOut(_buffer, bytes, nullptr, 0))
+            return false;
+        _fill -= bytes;
+        if(_fill)
+            memmove(_buffer, _buffer+bytes, _fill);
+        return true;
+    }
+
+    bool FrameWriter::write(const void* data, size_t bytes) {
+        if(!is_open() || _failed)
+            return false;
+        const char* p = static_cast<const char*>(data);
+        _written += bytes;
+        // Large writes skip the buffer, unless O_DIRECT needs them aligned.
+        if(!_direct && _fill+bytes > _capacity && bytes >= _capacity/2) {
+            const size_t fill = _fill;
+            _fill = 0;
+            return writeOut(_buffer, fill, p, bytes);
+        }
+        while(bytes) {
+            const size_t n = std::min(bytes, _capacity-_fill);
+            memcpy(_buffer+_fill, p, n);
+            _fill += n;
+            p += n;
+            bytes -= n;
+            if(_fill == _capacity && !flushBuffer(_capacity))
+                return false;
+        }
+        return true;
+    }
+
+    bool FrameWriter::flush() {
+        if(!is_open())
+            return false;
+        const size_t bytes = _direct? _fill/alignment*alignment: _fill;
+        if(bytes && !flushBuffer(bytes))
+            return false;
+#ifndef FRAMEGEN_POSIX
+        _stream.flush();
+#endif
+        return !_failed;
+    }
+
+    bool FrameWriter::close() {
+        if(!is_open())
+            return true;
+        bool ok = flush();
+#ifdef FRAMEGEN_POSIX
+#ifdef O_DIRECT
+        // The unaligned tail of a direct file goes through the page cache.
+        if(ok && _direct && _fill) {
+            fcntl(_fd, F_SETFL, fcntl(_fd, F_GETFL) & ~O_DIRECT);
+            _direct = false;
+            ok = flushBuffer(_fill);
+        }
+#endif
+        // Release preallocated space that was not used.
+        if(ok && _preallocate > _written)
+            ok = !ftruncate(_fd, _offset+_written);
+        if(::close(_fd))
+            ok = false;
+        _fd = -1;
+#else
+        _stream.close();
+        ok = ok && !_stream.fail();
+#endif
+        _direct = false;
+        _fill = 0;
+        return ok && !_failed;
+    }
+
+} // namespace framegen
@@ -0,0 +1,98 @@
+//==========================================================================
+// Name        : FrameWriter.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Buffered binary sink for files of consecutive frames.
+//============================================================================
+
+#ifndef FRAMEGEN_FRAMEWRITER_HPP_
+#define FRAMEGEN_FRAMEWRITER_HPP_
+
+#include <fstream>
+#include <string>
+
+#include "FrameGen.hpp"
+
+namespace framegen {
+
+// ==================================================================
+// Write-only sink for binary frame files. Frames are gathered in a large
+// page-aligned buffer that goes to the file in a single write() once full;
+// writes bigger than the buffer are passed on with writev() together with
+// whatever is still buffered. With direct I/O only whole pages are written
+// with O_DIRECT and the unaligned tail goes through the page cache on close().
+// ==================================================================
+class FrameWriter {
+ private:
+  std::string _filename;
+  int _fd = -1;
+  std::ofstream _stream;  // Only used without POSIX file descriptors.
+
+  char* _buffer = nullptr;
+  size_t _capacity = 0;  // Allocated buffer size, a multiple of alignment.
+  size_t _fill = 0;      // Bytes waiting in the buffer.
+  size_t _bufferBytes = default_buffer_bytes;
+
+  bool _wantDirect = false;
+  bool _direct = false;  // O_DIRECT is active on _fd.
+  unsigned long long _preallocate = 0;
+
+  unsigned long long _written = 0;  // Bytes accepted since open().
+  unsigned long long _offset = 0;   // File size when opened.
+  bool _failed = false;
+
+  bool allocate();
+  bool flushBuffer(size_t bytes);
+  bool writeOut(const char* a, size_t na, const char* b, size_t nb);
+
+ public:
+  static const size_t default_buffer_bytes = 4 << 20;
+  static const size_t alignment = 4096;  // Buffer and O_DIRECT block size.
+
+  FrameWriter() {}
+  explicit FrameWriter(const std::string& filename, bool append = false) {
+    open(filename, append);
+  }
+  ~FrameWriter();
+  FrameWriter(const FrameWriter&) = delete;
+  FrameWriter& operator=(const FrameWriter&) = delete;
+
+  // Settings, used by the next open(). The buffer size is rounded up to a
+  // multiple of alignment. Direct I/O silently falls back to buffered I/O
+  // where O_DIRECT is not supported. Preallocation reserves disk space with
+  // fallocate() without changing the file size.
+  void setBufferSize(size_t bytes) { _bufferBytes = bytes; }
+  void setDirect(bool direct) { _wantDirect = direct; }
+  void setPreallocate(unsigned long long bytes) { _preallocate = bytes; }
+
+  // Open a file, truncating it unless append is set.
+  bool open(const std::string& filename, bool append = false);
+  // Write out all buffered data and close the file.
+  bool close();
+
+  bool is_open() const { return _fd >= 0 || _stream.is_open(); }
+  bool direct() const { return _direct; }
+  bool good() const { return is_open() && !_failed; }
+  const std::string& filename() const { return _filename; }
+  // Bytes written since open(), including those still buffered.
+  unsigned long long bytes() const { return _written; }
+  size_t frames() const { return _written / num_frame_bytes; }
+
+  bool write(const void* data, size_t bytes);
+  bool write(const Frame& frame) { return write(frame.data(), num_frame_bytes); }
+  bool write(const Frame* frames, size_t Nframes) {
+    return write(frames->data(), Nframes * num_frame_bytes);
+  }
+  bool write(const ConstFrameView& frame) {
+    return write(frame.data(), num_frame_bytes);
+  }
+
+  // Hand the buffered data to the operating system. With direct I/O an
+  // unaligned tail stays buffered until close().
+  bool flush();
+};
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_FRAMEWRITER_HPP_ */
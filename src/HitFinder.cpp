@@ -0,0 +1,203 @@
+//============================================================================
+// Name        : HitFinder.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Trigger primitive generation from streams of frames.
+//============================================================================
+
+#include "src/HitFinder.hpp"
+#include "src/Cpu.hpp"
+#include "src/Pack.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace framegen {
+
+    namespace {
+        // Fractional bits of the running mean pedestal.
+        const unsigned mean_fraction_bits = 8;
+
+        // One pass over all channels without branches, so the compiler vectorises it. The updates are written with
+        // masks rather than conditional expressions, which GCC only turns into vector code for some ISAs. Returns
+        // whether any hit started or ended.
+        template<bool median>
+        FRAMEGEN_ALWAYS_INLINE bool processBody(const adc_t* adcs, HitFinder::Channels& st) {
+            // Read once: the byte stores to st.edge could alias them as far as the compiler knows.
+            const int32_t limit = st.medianLimit, shift = st.meanShift;
+            uint8_t any = 0;
+            for(unsigned c=0; c<num_ch_per_frame; c++) {
+                const int32_t x = adcs[c];
+                const int32_t p = st.pedestal[c];
+                const int32_t s = x - (median ? p : p >> mean_fraction_bits);
+                const int32_t over = s > st.threshold[c];
+                const int32_t was = st.samples[c] > 0;
+                const int32_t below = over - 1;  // All ones where the pedestal is updated.
+                if(median) {
+                    const int32_t a = st.accumulator[c];
+                    const int32_t acc = a + (x > p) - (x < p);
+                    const int32_t up = acc > limit, down = acc < -limit;
+                    st.pedestal[c] = p + ((up - down) & below);
+                    st.accumulator[c] = (a & ~below) | (acc & below & ((up | down) - 1));
+                } else {
+                    st.pedestal[c] = p + ((((x << mean_fraction_bits) - p) >> shift) & below);
+                }
+                st.samples[c] += over;
+                st.integral[c] += s & -over;
+                st.peak[c] = std::max(st.peak[c], s & -over);
+                const uint8_t edge = (over != was)*(1 + was);
+                st.edge[c] = edge;
+                any |= edge;
+            }
+            return any;
+        }
+
+        bool medianScalar(const adc_t* adcs, HitFinder::Channels& st) { return processBody<true>(adcs, st); }
+        bool meanScalar(const adc_t* adcs, HitFinder::Channels& st) { return processBody<false>(adcs, st); }
+
+#ifdef FRAMEGEN_X86
+        FRAMEGEN_TARGET("sse4.1")
+        bool medianSSE41(const adc_t* adcs, HitFinder::Channels& st) { return processBody<true>(adcs, st); }
+        FRAMEGEN_TARGET("sse4.1")
+        bool meanSSE41(const adc_t* adcs, HitFinder::Channels& st) { return processBody<false>(adcs, st); }
+        FRAMEGEN_TARGET("avx2")
+        bool medianAVX2(const adc_t* adcs, HitFinder::Channels& st) { return processBody<true>(adcs, st); }
+        FRAMEGEN_TARGET("avx2")
+        bool meanAVX2(const adc_t* adcs, HitFinder::Channels& st) { return processBody<false>(adcs, st); }
+#endif
+
+        typedef bool (*process_fn)(const adc_t*, HitFinder::Channels&);
+
+        struct HitKernels {
+            process_fn median;
+            process_fn mean;
+            const char* name;
+        };
+
+        HitKernels selectKernels() {
+#ifdef FRAMEGEN_X86
+            if(cpu::supports_avx2()) {
+                HitKernels k = {medianAVX2, meanAVX2, "avx2"};
+                return k;
+            }
+            if(cpu::supports_sse41()) {
+                HitKernels k = {medianSSE41, meanSSE41, "sse4.1"};
+                return k;
+            }
+#endif
+            HitKernels k = {medianScalar, meanScalar, "scalar"};
+            return k;
+        }
+
+        const HitKernels& kernels() {
+            static const HitKernels k = selectKernels();
+            return k;
+        }
+    } // namespace
+
+    HitFinder::HitFinder(const HitFinderOptions& options) { setOptions(options); }
+
+    void HitFinder::setOptions(const HitFinderOptions& options) {
+        _options = options;
+        if(!options.thresholds.empty() && options.thresholds.size() != num_ch_per_frame)
+            std::cout << "Warning (HitFinder::setOptions()): " << options.thresholds.size() << " thresholds for "
+                << num_ch_per_frame << " channels; using " << options.threshold << " for all." << std::endl;
+        for(unsigned ch=0; ch<num_ch_per_frame; ch++)
+            _ch.threshold[ch] = options.thresholds.size() == num_ch_per_frame ? options.thresholds[ch] : options.threshold;
+        _ch.medianLimit = options.medianLimit;
+        _ch.meanShift = std::min(options.meanShift, 16u);
+        reset();
+    }
+
+    void HitFinder::reset() {
+        _started = false;
+        _frames = 0;
+        _primitives = 0;
+        memset(_ch.pedestal, 0, sizeof(_ch.pedestal));
+        memset(_ch.accumulator, 0, sizeof(_ch.accumulator));
+        memset(_ch.samples, 0, sizeof(_ch.samples));
+        memset(_ch.peak, 0, sizeof(_ch.peak));
+        memset(_ch.integral, 0, sizeof(_ch.integral));
+    }
+
+    void HitFinder::start(const adc_t adcs[num_ch_per_frame]) {
+        const unsigned shift = _options.pedestal == HitFinderOptions::running_mean ? mean_fraction_bits : 0;
+        for(unsigned ch=0; ch<num_ch_per_frame; ch++)
+            _ch.pedestal[ch] = (int32_t)adcs[ch] << shift;
+        _started = true;
+    }
+
+    void HitFinder::emit(const unsigned ch, std::vector<TriggerPrimitive>& primitives) {
+        if((unsigned)_ch.samples[ch] >= _options.minSamples) {
+            TriggerPrimitive tp;
+            tp.channel = ch;
+            tp.startTime = _startTime[ch];
+            tp.timeOverThreshold = _ch.samples[ch]*frame_timestamp_step;
+            tp.peak = _ch.peak[ch];
+            tp.integral = _ch.integral[ch];
+            primitives.push_back(tp);
+            _primitives++;
+        }
+        _ch.samples[ch] = 0;
+        _ch.peak[ch] = 0;
+        _ch.integral[ch] = 0;
+    }
+
+    void HitFinder::process(const adc_t adcs[num_ch_per_frame], const uint64_t timestamp,
+                            std::vector<TriggerPrimitive>& primitives) {
+        if(!_started)
+            start(adcs);
+        const HitKernels& k = kernels();
+        const bool any = (_options.pedestal == HitFinderOptions::frugal_median ? k.median : k.mean)(adcs, _ch);
+        _frames++;
+        if(!any)
+            return;
+        // Few channels change state in a frame; skip eight at a time where none did.
+        for(unsigned c=0; c<num_ch_per_frame; c+=8) {
+            uint64_t flags;
+            memcpy(&flags, _ch.edge+c, 8);
+            if(!flags)
+                continue;
+            for(unsigned ch=c; ch<c+8; ch++) {
+                if(!_ch.edge[ch])
+                    continue;
+                // Hits that end did so with the previous frame.
+                if(_ch.edge[ch] == 1)
+                    _startTime[ch] = timestamp;
+                else
+                    emit(ch, primitives);
+            }
+        }
+    }
+
+    void HitFinder::process(const Frame& frame, std::vector<TriggerPrimitive>& primitives) {
+        adc_t adcs[num_ch_per_frame];
+        unpack(frame, adcs);
+        process(adcs, frame.timestamp(), primitives);
+    }
+
+    void HitFinder::process(const Frame* frames, const size_t Nframes, std::vector<TriggerPrimitive>& primitives) {
+        adc_t adcs[num_ch_per_frame];
+        for(size_t i=0; i<Nframes; i++) {
+            unpack(frames[i], adcs);
+            process(adcs, frames[i].timestamp(), primitives);
+        }
+    }
+
+    void HitFinder::flush(std::vector<TriggerPrimitive>& primitives) {
+        for(unsigned ch=0; ch<num_ch_per_frame; ch++)
+            if(_ch.samples[ch])
+                emit(ch, primitives);
+    }
+
+    float HitFinder::pedestal(const unsigned ch) const {
+        if(ch >= num_ch_per_frame)
+            return 0;
+        return _options.pedestal == HitFinderOptions::running_mean
+            ? _ch.pedestal[ch] / (float)(1 << mean_fraction_bits) : _ch.pedestal[ch];
+    }
+
+    const char* hitfinder_kernel() { return kernels().name; }
+
+} // namespace framegen
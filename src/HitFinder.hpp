@@ -0,0 +1,115 @@
+//==========================================================================
+// Name        : HitFinder.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Trigger primitive generation from streams of frames.
+//============================================================================
+
+#ifndef FRAMEGEN_HITFINDER_HPP_
+#define FRAMEGEN_HITFINDER_HPP_
+
+#include <vector>
+
+#include "FrameGen.hpp"
+
+namespace framegen {
+
+// A run of consecutive samples of one channel above threshold. Amplitudes are
+// relative to the channel pedestal, times are in timestamp units.
+struct TriggerPrimitive {
+  uint16_t channel = 0;  // As numbered by Frame::channel(ch).
+  uint64_t startTime = 0;
+  uint32_t timeOverThreshold = 0;
+  uint16_t peak = 0;
+  uint32_t integral = 0;
+};
+
+struct HitFinderOptions {
+  enum Pedestal {
+    // Moves one count towards the samples once they have been on the same
+    // side of it often enough (frugal streaming median).
+    frugal_median,
+    // Exponential moving average over 2^meanShift samples.
+    running_mean
+  };
+  Pedestal pedestal = frugal_median;
+  int medianLimit = 10;
+  unsigned meanShift = 6;
+
+  // Counts above the pedestal a sample must exceed, for every channel or, if
+  // given, per channel (num_ch_per_frame entries).
+  uint16_t threshold = 30;
+  std::vector<uint16_t> thresholds;
+  // Shorter runs, in samples, are dropped.
+  unsigned minSamples = 1;
+};
+
+// ==================================================================
+// Finds hits on the 256 channels of one link. The per-channel state is kept
+// as arrays and every frame is processed as one straight-line pass over all
+// channels, vectorised for the best ISA of the CPU: the pedestal is updated
+// where the sample is below threshold and the sums of running hits are
+// accumulated where it is above. Only channels whose hit starts or ends are
+// visited one by one afterwards.
+//
+// Pedestals start at the first sample of each channel; the pedestal of a
+// channel is frozen while it is over threshold.
+// ==================================================================
+class HitFinder {
+ public:
+  // Per-channel state. Keeping the arrays in one object tells the compiler
+  // they cannot overlap. The mean pedestal is kept with 8 fractional bits.
+  struct Channels {
+    int32_t pedestal[num_ch_per_frame];
+    int32_t accumulator[num_ch_per_frame];
+    int32_t threshold[num_ch_per_frame];
+    int32_t samples[num_ch_per_frame];  // Over threshold so far.
+    int32_t peak[num_ch_per_frame];
+    int32_t integral[num_ch_per_frame];
+    uint8_t edge[num_ch_per_frame];  // 1 where a hit starts, 2 where one ends.
+    int32_t medianLimit;
+    int32_t meanShift;
+  };
+
+ private:
+  HitFinderOptions _options;
+  bool _started = false;
+  uint64_t _frames = 0;
+  uint64_t _primitives = 0;
+  Channels _ch;
+  uint64_t _startTime[num_ch_per_frame];
+
+  void start(const adc_t adcs[num_ch_per_frame]);
+  void emit(unsigned ch, std::vector<TriggerPrimitive>& primitives);
+
+ public:
+  explicit HitFinder(const HitFinderOptions& options = HitFinderOptions());
+
+  // Changing the options restarts the pedestals.
+  void setOptions(const HitFinderOptions& options);
+  const HitFinderOptions& options() const { return _options; }
+  void reset();
+
+  // Process the channels of one frame, as unpacked by unpack(). Primitives
+  // of hits ending with this frame are appended.
+  void process(const adc_t adcs[num_ch_per_frame], uint64_t timestamp,
+               std::vector<TriggerPrimitive>& primitives);
+  void process(const Frame& frame, std::vector<TriggerPrimitive>& primitives);
+  void process(const Frame* frames, size_t Nframes,
+               std::vector<TriggerPrimitive>& primitives);
+  // Close the hits still running after the last frame.
+  void flush(std::vector<TriggerPrimitive>& primitives);
+
+  // Current pedestal of a channel in ADC counts.
+  float pedestal(unsigned ch) const;
+  uint64_t frames() const { return _frames; }
+  uint64_t primitives() const { return _primitives; }
+};
+
+// Name of the kernel selected for this CPU ("avx2", "sse4.1" or "scalar").
+const char* hitfinder_kernel();
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_HITFINDER_HPP_ */
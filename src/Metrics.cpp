@@ -0,0 +1,331 @@
+//============================================================================
+// Name        : Metrics.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Counters and latency histograms of the generator stages.
+//============================================================================
+
+#include "src/Metrics.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+namespace framegen {
+
+    namespace {
+        // Latencies in nanoseconds go into log-linear buckets: four per power of two, so a bucket is at most 25%
+        // wide and percentiles are good to about 12%.
+        const unsigned sub_bucket_bits = 2;
+        const unsigned sub_buckets = 1 << sub_bucket_bits;
+        const unsigned histogram_buckets = 64 * sub_buckets;
+
+        unsigned bucket(const uint64_t ns) {
+            if(ns < sub_buckets)
+                return ns;
+            const unsigned e = 63 - __builtin_clzll(ns);
+            return (e - sub_bucket_bits + 1) * sub_buckets + ((ns >> (e - sub_bucket_bits)) & (sub_buckets - 1));
+        }
+
+        // Middle of the range of values in bucket b.
+        double bucketValue(const unsigned b) {
+            if(b < sub_buckets)
+                return b;
+            const unsigned e = b / sub_buckets + sub_bucket_bits - 1;
+            return std::ldexp(sub_buckets + b % sub_buckets + 0.5, e - sub_bucket_bits);
+        }
+
+        // Written by one thread only, so updates are a relaxed load and store rather than a locked add; atomic so
+        // snapshots may read them at any time.
+        struct Counter {
+            std::atomic<uint64_t> value;
+            Counter() : value(0) {}
+            void add(const uint64_t n) { value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+            void raise(const uint64_t n) {
+                if(n > value.load(std::memory_order_relaxed))
+                    value.store(n, std::memory_order_relaxed);
+            }
+            uint64_t get() const { return value.load(std::memory_order_relaxed); }
+            void clear() { value.store(0, std::memory_order_relaxed); }
+        };
+
+        struct StageCounters {
+            Counter calls, frames, bytes, nanoseconds, max;
+            Counter histogram[histogram_buckets];
+        };
+
+        // Calls of a sampled stage since its last sample, and the latency of that sample. Only the owning
+        // thread touches them.
+        struct Pending {
+            uint64_t calls = 0, frames = 0, bytes = 0;
+            uint64_t latency = 0;
+        };
+
+        struct ThreadCounters {
+            StageCounters stages[num_metric_stages];
+            Pending pending[num_metric_stages];
+            uint64_t sampleCalls[num_metric_stages] = {};
+        };
+
+        // Add calls that each took about latency ns.
+        void add(StageCounters& c, const uint64_t calls, const uint64_t frames, const uint64_t bytes,
+                 const uint64_t latency) {
+            c.calls.add(calls);
+            c.frames.add(frames);
+            c.bytes.add(bytes);
+            c.nanoseconds.add(latency*calls);
+            c.max.raise(latency);
+            c.histogram[bucket(latency)].add(calls);
+        }
+
+        // Count the calls made since the last samples, at the latency of those samples.
+        void flush(ThreadCounters& block) {
+            for(unsigned st=0; st<num_metric_stages; st++) {
+                Pending& p = block.pending[st];
+                if(p.calls)
+                    add(block.stages[st], p.calls, p.frames, p.bytes, p.latency);
+                p = Pending();
+                block.sampleCalls[st] = 0;
+            }
+        }
+
+        // Counter blocks of every thread. A thread that exits hands its block back for the next new thread, counts
+        // and all, so the totals stay complete and short-lived workers do not pile up blocks.
+        class Registry {
+        private:
+            std::mutex _mutex;
+            std::vector<std::unique_ptr<ThreadCounters> > _blocks;
+            std::vector<ThreadCounters*> _free;
+            std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+
+        public:
+            ThreadCounters* acquire() {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if(!_free.empty()) {
+                    ThreadCounters* block = _free.back();
+                    _free.pop_back();
+                    return block;
+                }
+                _blocks.push_back(std::unique_ptr<ThreadCounters>(new ThreadCounters));
+                return _blocks.back().get();
+            }
+
+            void release(ThreadCounters* block) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _free.push_back(block);
+            }
+
+            MetricsSnapshot snapshot() {
+                std::lock_guard<std::mutex> lock(_mutex);
+                MetricsSnapshot s;
+                s.enabled = metrics::enabled();
+                s.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+                s.threads = _blocks.size();
+                std::vector<uint64_t> histogram(histogram_buckets);
+                for(unsigned st=0; st<num_metric_stages; st++) {
+                    StageMetrics& m = s.stages[st];
+                    m.name = metric_stage_name(static_cast<MetricStage>(st));
+                    std::fill(histogram.begin(), histogram.end(), 0);
+                    uint64_t ns = 0, max = 0;
+                    for(size_t t=0; t<_blocks.size(); t++) {
+                        const StageCounters& c = _blocks[t]->stages[st];
+                        m.calls += c.calls.get();
+                        m.frames += c.frames.get();
+                        m.bytes += c.bytes.get();
+                        ns += c.nanoseconds.get();
+                        max = std::max(max, c.max.get());
+                        for(unsigned b=0; b<histogram_buckets; b++)
+                            histogram[b] += c.histogram[b].get();
+                    }
+                    m.seconds = ns / 1e9;
+                    m.max = max / 1e3;
+                    if(s.elapsed > 0) {
+                        m.framesPerSecond = m.frames / s.elapsed;
+                        m.bytesPerSecond = m.bytes / s.elapsed;
+                    }
+                    // The histogram is read while threads add to it, so its total is counted rather than taken
+                    // from the calls.
+                    uint64_t total = 0;
+                    for(unsigned b=0; b<histogram_buckets; b++)
+                        total += histogram[b];
+                    const double quantiles[2] = {0.5, 0.99};
+                    double* results[2] = {&m.p50, &m.p99};
+                    for(unsigned q=0; q<2 && total; q++) {
+                        const uint64_t rank = std::max<uint64_t>(1, (uint64_t)(quantiles[q] * total + 0.5));
+                        uint64_t seen = 0;
+                        unsigned b = 0;
+                        while(b < histogram_buckets-1 && (seen += histogram[b]) < rank)
+                            b++;
+                        *results[q] = std::min(bucketValue(b), (double)max) / 1e3;
+                    }
+                }
+                return s;
+            }
+
+            void reset() {
+                std::lock_guard<std::mutex> lock(_mutex);
+                for(size_t t=0; t<_blocks.size(); t++) {
+                    for(unsigned st=0; st<num_metric_stages; st++) {
+                        StageCounters& c = _blocks[t]->stages[st];
+                        c.calls.clear();
+                        c.frames.clear();
+                        c.bytes.clear();
+                        c.nanoseconds.clear();
+                        c.max.clear();
+                        for(unsigned b=0; b<histogram_buckets; b++)
+                            c.histogram[b].clear();
+                    }
+                }
+                _start = std::chrono::steady_clock::now();
+            }
+        };
+
+        Registry& registry() {
+            static Registry r;
+            return r;
+        }
+
+        struct ThreadSlot {
+            ThreadCounters* block = nullptr;
+            ~ThreadSlot() {
+                if(block) {
+                    flush(*block);
+                    registry().release(block);
+                }
+            }
+        };
+
+        ThreadCounters& local() {
+            static thread_local ThreadSlot slot;
+            if(!slot.block)
+                slot.block = registry().acquire();
+            return *slot.block;
+        }
+
+        void writeStage(std::ostream& out, const StageMetrics& m) {
+            out << "\"" << m.name << "\": {\"calls\": " << m.calls << ", \"frames\": " << m.frames
+                << ", \"bytes\": " << m.bytes << ", \"seconds\": " << m.seconds
+                << ", \"frames_per_s\": " << m.framesPerSecond << ", \"bytes_per_s\": " << m.bytesPerSecond
+                << ", \"p50_us\": " << m.p50 << ", \"p99_us\": " << m.p99 << ", \"max_us\": " << m.max << "}";
+        }
+    } // namespace
+
+    const char* metric_stage_name(const MetricStage stage) {
+        switch(stage) {
+        case metric_fill: return "fill";
+        case metric_checksum: return "checksum";
+        case metric_crc: return "crc";
+        case metric_compress: return "compress";
+        case metric_write: return "write";
+        default: return "unknown";
+        }
+    }
+
+    std::string MetricsSnapshot::json() const {
+        std::ostringstream out;
+        out << "{\"enabled\": " << (enabled? "true": "false") << ", \"elapsed_s\": " << elapsed
+            << ", \"threads\": " << threads << ", \"stages\": {";
+        for(unsigned st=0; st<num_metric_stages; st++) {
+            out << (st? ", ": "");
+            writeStage(out, stages[st]);
+        }
+        out << "}}";
+        return out.str();
+    }
+
+    namespace metrics {
+        bool enabled() {
+#ifdef FRAMEGEN_METRICS
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        void record(const MetricStage stage, const uint64_t nanoseconds, const uint64_t frames, const uint64_t bytes) {
+            if((unsigned)stage >= num_metric_stages)
+                return;
+            add(local().stages[stage], 1, frames, bytes, nanoseconds);
+        }
+
+        bool sample(const MetricStage stage, const uint64_t frames, const uint64_t bytes) {
+            if((unsigned)stage >= num_metric_stages)
+                return false;
+            ThreadCounters& block = local();
+            if(block.sampleCalls[stage]++ % metric_sample_period == 0)
+                return true;
+            Pending& p = block.pending[stage];
+            p.calls++;
+            p.frames += frames;
+            p.bytes += bytes;
+            return false;
+        }
+
+        void recordSample(const MetricStage stage, const uint64_t nanoseconds, const uint64_t frames,
+                          const uint64_t bytes) {
+            if((unsigned)stage >= num_metric_stages)
+                return;
+            ThreadCounters& block = local();
+            Pending& p = block.pending[stage];
+            add(block.stages[stage], p.calls+1, p.frames+frames, p.bytes+bytes, nanoseconds);
+            p = Pending();
+            p.latency = nanoseconds;
+        }
+
+        MetricsSnapshot snapshot() { return registry().snapshot(); }
+
+        void reset() { registry().reset(); }
+    } // namespace metrics
+
+    //=============
+    // MetricsDump
+    //=============
+    bool MetricsDump::start(const std::string& filename, const double intervalSeconds) {
+        stop();
+        _filename = filename;
+        _interval = std::chrono::milliseconds(std::max<long long>(1, (long long)(intervalSeconds * 1e3)));
+        _stop = false;
+        if(!dump())
+            return false;
+        _thread = std::thread(&MetricsDump::run, this);
+        return true;
+    }
+
+    void MetricsDump::stop() {
+        if(!_thread.joinable())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        _thread.join();
+        dump();
+    }
+
+    bool MetricsDump::dump() {
+        std::ofstream file(_filename, std::ios::app);
+        if(!file) {
+            std::cout << "Error (MetricsDump::dump()): file " << _filename << " could not be opened." << std::endl;
+            return false;
+        }
+        file << metrics::snapshot().json() << '\n';
+        return true;
+    }
+
+    void MetricsDump::run() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while(!_wake.wait_for(lock, _interval, [this] { return _stop; })) {
+            lock.unlock();
+            dump();
+            lock.lock();
+        }
+    }
+
+} // namespace framegen
@@ -0,0 +1,200 @@
+//==========================================================================
+// Name        : Metrics.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Counters and latency histograms of the generator stages.
+//============================================================================
+
+#ifndef FRAMEGEN_METRICS_HPP_
+#define FRAMEGEN_METRICS_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "Types.hpp"
+
+namespace framegen {
+
+// Stages timed by FRAMEGEN_METRICS_SCOPE(). Stages nest: the fill time
+// includes the checksum and CRC times.
+enum MetricStage {
+  metric_fill,      // FrameGen::fill(): header, noise, signal and packing.
+  metric_checksum,  // COLDATA checksums in resetChecksums(), sampled.
+  metric_crc,       // Frame CRC32 in resetChecksums(), sampled.
+  metric_compress,  // One chunk through Compressor::compress().
+  metric_write,     // Frames handed to a file writer by the generators.
+  num_metric_stages
+};
+
+const char* metric_stage_name(MetricStage stage);
+
+struct StageMetrics {
+  const char* name = "";
+  uint64_t calls = 0;
+  uint64_t frames = 0;
+  uint64_t bytes = 0;
+  double seconds = 0;  // Time in the stage, summed over threads.
+  // Over the wall-clock time of the snapshot.
+  double framesPerSecond = 0;
+  double bytesPerSecond = 0;
+  // Latency of one call, in microseconds.
+  double p50 = 0;
+  double p99 = 0;
+  double max = 0;
+};
+
+struct MetricsSnapshot {
+  bool enabled = false;  // Built with FRAMEGEN_METRICS.
+  double elapsed = 0;    // Seconds since the last metrics::reset().
+  // Per-thread counter blocks. A block is handed on when its thread exits, so
+  // this is the most threads that have been recording at the same time.
+  unsigned threads = 0;
+  StageMetrics stages[num_metric_stages];
+
+  // One line of JSON.
+  std::string json() const;
+};
+
+namespace metrics {
+
+// True if the library was built with FRAMEGEN_METRICS; without it nothing is
+// recorded and snapshots are empty.
+bool enabled();
+
+// Add one call of the given latency to the calling thread's counters. Every
+// thread has its own, so recording is a handful of relaxed stores; they are
+// only added up by snapshot().
+void record(MetricStage stage, uint64_t nanoseconds, uint64_t frames,
+            uint64_t bytes);
+
+// Calls of a stage per sample for FRAMEGEN_METRICS_SAMPLED_SCOPE().
+const unsigned metric_sample_period = 64;
+
+// True for one in every metric_sample_period calls, per stage and thread,
+// starting with the first; the other calls are set aside with their frames
+// and bytes. recordSample() records the timed call together with the calls
+// set aside since the previous one, at its latency. Calls set aside after
+// the last sample of a thread are counted when the thread exits.
+bool sample(MetricStage stage, uint64_t frames, uint64_t bytes);
+void recordSample(MetricStage stage, uint64_t nanoseconds, uint64_t frames,
+                  uint64_t bytes);
+
+// Totals over all threads, with rates over the time since reset().
+MetricsSnapshot snapshot();
+
+// Zero every counter and restart the clock. Calls being recorded at the
+// same time may survive the reset.
+void reset();
+
+// Records the lifetime of the scope as one call of the stage.
+class ScopedTimer {
+ private:
+  const MetricStage _stage;
+  const uint64_t _frames;
+  const uint64_t _bytes;
+  const std::chrono::steady_clock::time_point _start;
+
+ public:
+  ScopedTimer(MetricStage stage, uint64_t frames = 0, uint64_t bytes = 0)
+      : _stage(stage),
+        _frames(frames),
+        _bytes(bytes),
+        _start(std::chrono::steady_clock::now()) {}
+  ~ScopedTimer() {
+    record(_stage,
+           std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - _start)
+               .count(),
+           _frames, _bytes);
+  }
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+// Like ScopedTimer, but only times one call in metric_sample_period (see
+// sample()). For stages that take about as long as reading the clock twice,
+// such as the checksums and CRC of a single frame; the other calls only add
+// to the thread's pending counts.
+class SampledTimer {
+ private:
+  const MetricStage _stage;
+  const uint64_t _frames;
+  const uint64_t _bytes;
+  const bool _sampled;
+  std::chrono::steady_clock::time_point _start;
+
+ public:
+  SampledTimer(MetricStage stage, uint64_t frames = 0, uint64_t bytes = 0)
+      : _stage(stage),
+        _frames(frames),
+        _bytes(bytes),
+        _sampled(sample(stage, frames, bytes)) {
+    if (_sampled) _start = std::chrono::steady_clock::now();
+  }
+  ~SampledTimer() {
+    if (_sampled)
+      recordSample(_stage,
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - _start)
+                       .count(),
+                   _frames, _bytes);
+  }
+  SampledTimer(const SampledTimer&) = delete;
+  SampledTimer& operator=(const SampledTimer&) = delete;
+};
+
+}  // namespace metrics
+
+// Times the rest of the enclosing scope, every time or sampled. Compile to
+// nothing unless FRAMEGEN_METRICS is defined (the CMake option of the same
+// name).
+#define FRAMEGEN_METRICS_CONCAT_(a, b) a##b
+#define FRAMEGEN_METRICS_CONCAT(a, b) FRAMEGEN_METRICS_CONCAT_(a, b)
+#ifdef FRAMEGEN_METRICS
+#define FRAMEGEN_METRICS_SCOPE(stage, frames, bytes)                   \
+  ::framegen::metrics::ScopedTimer FRAMEGEN_METRICS_CONCAT(           \
+      framegen_metrics_scope_, __LINE__)(stage, frames, bytes)
+#define FRAMEGEN_METRICS_SAMPLED_SCOPE(stage, frames, bytes)           \
+  ::framegen::metrics::SampledTimer FRAMEGEN_METRICS_CONCAT(          \
+      framegen_metrics_scope_, __LINE__)(stage, frames, bytes)
+#else
+#define FRAMEGEN_METRICS_SCOPE(stage, frames, bytes) ((void)0)
+#define FRAMEGEN_METRICS_SAMPLED_SCOPE(stage, frames, bytes) ((void)0)
+#endif
+
+// ==================================================================
+// Appends a snapshot as a line of JSON to a file at a fixed interval, from a
+// thread of its own, and once more when stopped. The file can be followed
+// with tail -f while a long run is going.
+// ==================================================================
+class MetricsDump {
+ private:
+  std::string _filename;
+  std::chrono::milliseconds _interval{1000};
+  std::thread _thread;
+  std::mutex _mutex;
+  std::condition_variable _wake;
+  bool _stop = false;
+
+  bool dump();
+  void run();
+
+ public:
+  MetricsDump() {}
+  ~MetricsDump() { stop(); }
+  MetricsDump(const MetricsDump&) = delete;
+  MetricsDump& operator=(const MetricsDump&) = delete;
+
+  // Returns false if the file cannot be opened for appending.
+  bool start(const std::string& filename, double intervalSeconds = 1);
+  void stop();
+  bool running() const { return _thread.joinable(); }
+};
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_METRICS_HPP_ */
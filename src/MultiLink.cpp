@@ -0,0 +1,145 @@
+//============================================================================
+// Name        : MultiLink.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Emulation of many WIB links at once.
+//============================================================================
+
+#include "src/MultiLink.hpp"
+#include "src/FrameWriter.hpp"
+
+#include <atomic>
+#include <random>
+#include <thread>
+
+namespace framegen {
+
+    namespace {
+        // Widths of the fiber, slot and crate fields of the WIB header.
+        const unsigned max_fibers = 1 << 3, max_slots = 1 << 5, max_crates = 1 << 3;
+    } // namespace
+
+    std::vector<LinkId> Topology::links() const {
+        std::vector<LinkId> list;
+        if(firstCrate + crates > max_crates || firstSlot + slots > max_slots || firstFiber + fibers > max_fibers) {
+            std::cout << "Error (Topology::links()): the topology does not fit the WIB header (at most " << max_crates
+                << " crates, " << max_slots << " slots and " << max_fibers << " fibers)." << std::endl;
+            return list;
+        }
+        for(unsigned c=0; c<crates; c++)
+            for(unsigned s=0; s<slots; s++)
+                for(unsigned f=0; f<fibers; f++)
+                    list.push_back(LinkId(firstCrate+c, firstSlot+s, firstFiber+f));
+        return list;
+    }
+
+    MultiLinkGen::MultiLinkGen(const Topology& topology) : MultiLinkGen(topology.links()) {}
+
+    MultiLinkGen::MultiLinkGen(const std::vector<LinkId>& links) : _links(links) {
+        for(size_t i=0; i<_links.size(); i++) {
+            _clocks.push_back(std::unique_ptr<TimestampClock>(new TimestampClock()));
+            _generators.push_back(std::unique_ptr<FrameGen>(new FrameGen()));
+            _generators[i]->setLink(_links[i]);
+            _generators[i]->setClock(*_clocks[i]);
+        }
+        setTimestamp(TimestampClock().next());
+        std::random_device rd;
+        seed((uint64_t)rd() << 32 | rd());
+    }
+
+    void MultiLinkGen::setPedestal(const uint16_t pedestal) {
+        for(size_t i=0; i<_generators.size(); i++)
+            _generators[i]->setPedestal(pedestal);
+    }
+
+    void MultiLinkGen::setAmplitude(const uint16_t amplitude) {
+        for(size_t i=0; i<_generators.size(); i++)
+            _generators[i]->setAmplitude(amplitude);
+    }
+
+    void MultiLinkGen::setErrorProbability(const double probability) {
+        for(size_t i=0; i<_generators.size(); i++)
+            _generators[i]->setErrorProbability(probability);
+    }
+
+    void MultiLinkGen::seed(uint64_t seed) {
+        // NoiseGen::seed() runs the value through splitmix64, so neighbouring values give unrelated streams.
+        for(size_t i=0; i<_generators.size(); i++)
+            _generators[i]->noise().seed(seed + 0x9E3779B97F4A7C15ull*i);
+    }
+
+    void MultiLinkGen::setSignal(const SignalOptions& options) {
+        for(size_t i=0; i<_generators.size(); i++)
+            _generators[i]->setSignal(options);
+    }
+
+    void MultiLinkGen::setTimestamp(const uint64_t timestamp) {
+        for(size_t i=0; i<_clocks.size(); i++)
+            _clocks[i]->reset(timestamp);
+    }
+
+    void MultiLinkGen::setThreads(const unsigned threads) {
+        _threads = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    bool MultiLinkGen::generate(const unsigned long Nframes, const Sink& sink, const unsigned long batchFrames) {
+        if(_links.empty()) {
+            std::cout << "Error (MultiLinkGen::generate()): there are no links to generate frames for." << std::endl;
+            return false;
+        }
+        const unsigned threads = std::max<size_t>(1, std::min<size_t>(_threads, _links.size()));
+        const unsigned long batch = std::max(1ul, batchFrames);
+        std::atomic<bool> ok(true);
+
+        // Thread t owns links t, t+threads, ...; its frame buffer is reused for all of them.
+        auto work = [&](unsigned t) {
+            std::vector<Frame> frames;
+            for(unsigned long first=0; first<Nframes && ok; first+=batch) {
+                const unsigned long count = std::min(batch, Nframes-first);
+                for(size_t i=t; i<_links.size() && ok; i+=threads) {
+                    _generators[i]->generateBuffer(frames, count);
+                    if(!sink(i, frames.data(), count))
+                        ok = false;
+                }
+            }
+        };
+        if(threads == 1) {
+            work(0);
+        } else {
+            std::vector<std::thread> workers;
+            for(unsigned t=0; t<threads; t++)
+                workers.push_back(std::thread(work, t));
+            for(unsigned t=0; t<threads; t++)
+                workers[t].join();
+        }
+        return ok;
+    }
+
+    std::string MultiLinkGen::fileName(const size_t i, const std::string& path, const std::string& prefix) const {
+        return path + prefix + "_crate" + std::to_string(_links[i].crate) + "_slot" + std::to_string(_links[i].slot)
+            + "_fiber" + std::to_string(_links[i].fiber) + ".frame";
+    }
+
+    bool MultiLinkGen::generateFiles(const unsigned long Nframes, const std::string& path, const std::string& prefix) {
+        if(_links.empty()) {
+            std::cout << "Error (MultiLinkGen::generateFiles()): there are no links to generate frames for." << std::endl;
+            return false;
+        }
+        std::vector<std::unique_ptr<FrameWriter> > writers;
+        for(size_t i=0; i<_links.size(); i++) {
+            writers.push_back(std::unique_ptr<FrameWriter>(new FrameWriter()));
+            writers[i]->setBufferSize(1 << 20);
+            writers[i]->setPreallocate((unsigned long long)Nframes*num_frame_bytes);
+            if(!writers[i]->open(fileName(i, path, prefix)))
+                return false;
+        }
+        bool ok = generate(Nframes, [&](size_t i, const Frame* frames, unsigned long count) {
+            return writers[i]->write(frames, count);
+        });
+        for(size_t i=0; i<writers.size(); i++)
+            ok = writers[i]->close() && ok;
+        return ok;
+    }
+
+} // namespace framegen
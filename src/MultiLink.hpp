@@ -0,0 +1,91 @@
+//==========================================================================
+// Name        : MultiLink.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Emulation of many WIB links at once.
+//============================================================================
+
+#ifndef FRAMEGEN_MULTILINK_HPP_
+#define FRAMEGEN_MULTILINK_HPP_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "FrameGen.hpp"
+
+namespace framegen {
+
+// A block of crates x slots x fibers links, numbered from the first of each.
+// The default is one APA: five WIBs with four fibers each.
+struct Topology {
+  unsigned crates = 1, slots = 5, fibers = 4;
+  unsigned firstCrate = 0, firstSlot = 0, firstFiber = 0;
+
+  // Links in crate, slot, fiber order. Empty if any number does not fit its
+  // header field.
+  std::vector<LinkId> links() const;
+};
+
+// ==================================================================
+// Generates frames for a set of links. Every link has a fixed identity, its
+// own noise stream and its own clock; the clocks start together and advance
+// one step per frame, so frame n of every link carries the same timestamp.
+// Links are sharded across the worker threads, each thread generating its
+// links in turn a batch at a time so they progress together.
+// ==================================================================
+class MultiLinkGen {
+ private:
+  std::vector<LinkId> _links;
+  std::vector<std::unique_ptr<FrameGen> > _generators;
+  std::vector<std::unique_ptr<TimestampClock> > _clocks;
+  unsigned _threads = 1;
+
+ public:
+  // Called with the index of the link a batch of frames belongs to. Calls
+  // for different links may come from different threads at once.
+  typedef std::function<bool(size_t, const Frame*, unsigned long)> Sink;
+
+  explicit MultiLinkGen(const Topology& topology = Topology());
+  explicit MultiLinkGen(const std::vector<LinkId>& links);
+
+  size_t size() const { return _links.size(); }
+  const LinkId& link(size_t i) const { return _links[i]; }
+  // Per-link access, e.g. for per-channel noise maps.
+  FrameGen& generator(size_t i) { return *_generators[i]; }
+
+  // Noise settings for every link.
+  void setPedestal(uint16_t pedestal);
+  void setAmplitude(uint16_t amplitude);
+  void setErrorProbability(double probability);
+  // Link i draws from a stream seeded with a value derived from seed and i.
+  void seed(uint64_t seed);
+  // Signal injection on every link, with independent events per link. Call
+  // after seed() for reproducible signal.
+  void setSignal(const SignalOptions& options);
+  // Timestamp of the next frame of every link.
+  void setTimestamp(uint64_t timestamp);
+  uint64_t getTimestamp() const { return _clocks.empty() ? 0 : _clocks[0]->next(); }
+
+  // Worker threads; zero selects one per hardware core. There are never more
+  // threads than links.
+  void setThreads(unsigned threads);
+  unsigned getThreads() const { return _threads; }
+
+  // Generate Nframes frames for every link. Both generators return false if
+  // there are no links, e.g. for a topology that does not fit the header.
+  bool generate(unsigned long Nframes, const Sink& sink,
+                unsigned long batchFrames = 256);
+  // Write Nframes frames per link to one binary file per link, named
+  // path + prefix + "_crate<c>_slot<s>_fiber<f>.frame".
+  bool generateFiles(unsigned long Nframes, const std::string& path = "",
+                     const std::string& prefix = "link");
+  std::string fileName(size_t i, const std::string& path = "",
+                       const std::string& prefix = "link") const;
+};
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_MULTILINK_HPP_ */
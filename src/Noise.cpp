@@ -0,0 +1,153 @@
+//============================================================================
+// Name        : Noise.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Batch noise generator with per-channel pedestal/RMS maps.
+//============================================================================
+
+#include "src/Noise.hpp"
+#include "src/Cpu.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace framegen {
+
+    namespace {
+        // Largest value the 12-bit ADCs can hold.
+        const float max_adc = 4095.0f;
+
+        // Mean and standard deviation of a sum of eight uniform 16-bit values.
+        const float irwin_hall_mean = 8 * 32767.5f;
+        const float irwin_hall_scale = 1.0f / 53509.2f; // 1/(65536*sqrt(8/12))
+
+        inline uint64_t rotl(const uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+        uint64_t splitmix64(uint64_t& x) {
+            uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        // Sum of the four 16-bit fields of a 64-bit draw.
+        FRAMEGEN_ALWAYS_INLINE uint32_t sum16(const uint64_t x) {
+            const uint64_t pairs = (x & 0x0000FFFF0000FFFFULL) + ((x >> 16) & 0x0000FFFF0000FFFFULL);
+            return (uint32_t)pairs + (uint32_t)(pairs >> 32);
+        }
+
+        FRAMEGEN_ALWAYS_INLINE void generateBody(uint64_t (&state)[4][NoiseGen::num_lanes], uint64_t* random,
+                                                 const float* pedestal, const float* rms, adc_t* out) {
+            // xoshiro256++, one independent stream per lane.
+            for(unsigned i=0; i<2*num_ch_per_frame; i+=NoiseGen::num_lanes) {
+                for(unsigned l=0; l<NoiseGen::num_lanes; l++) {
+                    random[i+l] = rotl(state[0][l] + state[3][l], 23) + state[0][l];
+                    const uint64_t t = state[1][l] << 17;
+                    state[2][l] ^= state[0][l];
+                    state[3][l] ^= state[1][l];
+                    state[1][l] ^= state[2][l];
+                    state[0][l] ^= state[3][l];
+                    state[2][l] ^= t;
+                    state[3][l] = rotl(state[3][l], 45);
+                }
+            }
+            // Scale, round and clamp. Negative values end up at zero rather than being redrawn.
+            for(unsigned ch=0; ch<num_ch_per_frame; ch++) {
+                const float gauss = ((float)(sum16(random[ch]) + sum16(random[num_ch_per_frame+ch])) - irwin_hall_mean)
+                    * irwin_hall_scale;
+                float value = pedestal[ch] + rms[ch]*gauss + 0.5f;
+                value = value < 0.0f ? 0.0f : value;
+                value = value > max_adc ? max_adc : value;
+                out[ch] = (adc_t)(int)value;
+            }
+        }
+
+        void generateScalar(uint64_t (&state)[4][NoiseGen::num_lanes], uint64_t* random, const float* pedestal,
+                            const float* rms, adc_t* out) {
+            generateBody(state, random, pedestal, rms, out);
+        }
+
+#ifdef FRAMEGEN_X86
+        FRAMEGEN_TARGET("avx2")
+        void generateAVX2(uint64_t (&state)[4][NoiseGen::num_lanes], uint64_t* random, const float* pedestal,
+                          const float* rms, adc_t* out) {
+            generateBody(state, random, pedestal, rms, out);
+        }
+#endif
+
+        typedef void (*generate_fn)(uint64_t (&)[4][NoiseGen::num_lanes], uint64_t*, const float*, const float*,
+                                    adc_t*);
+
+        generate_fn selectKernel() {
+#ifdef FRAMEGEN_X86
+            if(cpu::supports_avx2())
+                return generateAVX2;
+#endif
+            return generateScalar;
+        }
+
+        generate_fn kernel() {
+            static const generate_fn k = selectKernel();
+            return k;
+        }
+    } // namespace
+
+    NoiseGen::NoiseGen(uint64_t seed) {
+        this->seed(seed);
+        setPedestal(250);
+        setRMS(0);
+    }
+
+    void NoiseGen::seed(uint64_t seed) {
+        for(unsigned i=0; i<4; i++)
+            for(unsigned l=0; l<num_lanes; l++)
+                _state[i][l] = splitmix64(seed);
+        for(unsigned i=0; i<4; i++)
+            _scalar[i] = splitmix64(seed);
+    }
+
+    void NoiseGen::setPedestal(float pedestal) {
+        for(unsigned ch=0; ch<num_ch_per_frame; ch++)
+            _pedestal[ch] = pedestal;
+    }
+
+    void NoiseGen::setRMS(float rms) {
+        for(unsigned ch=0; ch<num_ch_per_frame; ch++)
+            _rms[ch] = rms;
+    }
+
+    bool NoiseGen::setPedestalMap(const std::vector<float>& pedestals) {
+        if(pedestals.size() != num_ch_per_frame) {
+            std::cout << "Error (NoiseGen::setPedestalMap()): expected " << num_ch_per_frame << " pedestals, got " << pedestals.size() << "." << std::endl;
+            return false;
+        }
+        std::copy(pedestals.begin(), pedestals.end(), _pedestal);
+        return true;
+    }
+
+    bool NoiseGen::setRMSMap(const std::vector<float>& rms) {
+        if(rms.size() != num_ch_per_frame) {
+            std::cout << "Error (NoiseGen::setRMSMap()): expected " << num_ch_per_frame << " RMS values, got " << rms.size() << "." << std::endl;
+            return false;
+        }
+        std::copy(rms.begin(), rms.end(), _rms);
+        return true;
+    }
+
+    void NoiseGen::generate(adc_t out[num_ch_per_frame]) { kernel()(_state, _random, _pedestal, _rms, out); }
+
+    // xoshiro256**.
+    uint64_t NoiseGen::next() {
+        const uint64_t result = rotl(_scalar[1]*5, 7)*9;
+        const uint64_t t = _scalar[1] << 17;
+        _scalar[2] ^= _scalar[0];
+        _scalar[3] ^= _scalar[1];
+        _scalar[1] ^= _scalar[2];
+        _scalar[0] ^= _scalar[3];
+        _scalar[2] ^= t;
+        _scalar[3] = rotl(_scalar[3], 45);
+        return result;
+    }
+
+} // namespace framegen
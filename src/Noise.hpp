@@ -0,0 +1,65 @@
+//==========================================================================
+// Name        : Noise.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Batch noise generator with per-channel pedestal/RMS maps.
+//============================================================================
+
+#ifndef FRAMEGEN_NOISE_HPP_
+#define FRAMEGEN_NOISE_HPP_
+
+#include <vector>
+
+#include "Types.hpp"
+
+namespace framegen {
+
+// =================================================================
+// Noise generator that draws all 256 channels of a frame at once.
+// =================================================================
+// Random numbers come from eight interleaved xoshiro256++ streams so the
+// generator loop vectorises. Every sample is the sum of eight 16-bit
+// uniforms (Irwin-Hall), which approximates a Gaussian out to ~4.9 sigma and
+// is then scaled by the channel's RMS and offset by its pedestal.
+class NoiseGen {
+ public:
+  static const unsigned num_lanes = 8;
+
+  explicit NoiseGen(uint64_t seed = 0);
+
+  // (Re)seed all streams. Generators with different seeds are independent.
+  void seed(uint64_t seed);
+
+  // Flat noise: the same pedestal/RMS on every channel.
+  void setPedestal(float pedestal);
+  void setRMS(float rms);
+
+  // Per-channel maps, indexed like Frame::channel(ch). The vectors must hold
+  // num_ch_per_frame entries.
+  bool setPedestalMap(const std::vector<float>& pedestals);
+  bool setRMSMap(const std::vector<float>& rms);
+  float pedestal(unsigned ch) const { return _pedestal[ch]; }
+  float rms(unsigned ch) const { return _rms[ch]; }
+  const float* pedestals() const { return _pedestal; }
+  const float* rmsMap() const { return _rms; }
+
+  // Draw one frame of samples, rounded and clamped to the 12-bit ADC range.
+  void generate(adc_t out[num_ch_per_frame]);
+
+  // Scalar draws for everything that is not channel noise (error bits etc.).
+  uint64_t next();
+  double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+ private:
+  uint64_t _state[4][num_lanes];
+  // Two 64-bit draws (eight 16-bit uniforms) per sample.
+  uint64_t _random[2 * num_ch_per_frame];
+  float _pedestal[num_ch_per_frame];
+  float _rms[num_ch_per_frame];
+  uint64_t _scalar[4];
+};
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_NOISE_HPP_ */
@@ -0,0 +1,199 @@
+//============================================================================
+// Name        : Pack.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Bulk packing and unpacking of the 12-bit COLDATA channels.
+//============================================================================
+
+#include "src/Pack.hpp"
+#include "src/Cpu.hpp"
+
+namespace framegen {
+
+    // Every pair of streams (ADCs 2n and 2n+1) occupies six consecutive words of a COLDATA block. Seen per stream, the
+    // even ADC owns bytes 0 and 2 of each word and the odd ADC bytes 1 and 3, which gives each stream a contiguous
+    // little-endian 96-bit string holding its eight 12-bit channels.
+    static const unsigned num_words_per_pair = 6;
+    static const unsigned num_pairs_per_block = 4;
+
+    //========
+    // Scalar
+    //========
+    static void unpack_scalar(const word_t* adcs, adc_t* out) {
+        for(unsigned p=0; p<num_pairs_per_block; p++) {
+            const word_t* w = adcs + p*num_words_per_pair;
+            for(unsigned half=0; half<2; half++) {
+                uint64_t even = 0, odd = 0;
+                for(unsigned k=0; k<3; k++) {
+                    const word_t word = w[half*3+k];
+                    even |= (uint64_t)((word & 0xFF) | ((word>>8) & 0xFF00)) << (16*k);
+                    odd |= (uint64_t)(((word>>8) & 0xFF) | ((word>>16) & 0xFF00)) << (16*k);
+                }
+                for(unsigned ch=0; ch<4; ch++) {
+                    out[p*16 + half*4 + ch] = (even >> (12*ch)) & 0xFFF;
+                    out[p*16 + 8 + half*4 + ch] = (odd >> (12*ch)) & 0xFFF;
+                }
+            }
+        }
+    }
+
+    static void pack_scalar(word_t* adcs, const adc_t* in) {
+        for(unsigned p=0; p<num_pairs_per_block; p++) {
+            word_t* w = adcs + p*num_words_per_pair;
+            for(unsigned half=0; half<2; half++) {
+                uint64_t even = 0, odd = 0;
+                for(unsigned ch=0; ch<4; ch++) {
+                    even |= (uint64_t)(in[p*16 + half*4 + ch] & 0xFFF) << (12*ch);
+                    odd |= (uint64_t)(in[p*16 + 8 + half*4 + ch] & 0xFFF) << (12*ch);
+                }
+                for(unsigned k=0; k<3; k++) {
+                    const word_t e = (even >> (16*k)) & 0xFFFF;
+                    const word_t o = (odd >> (16*k)) & 0xFFFF;
+                    w[half*3+k] = (e & 0xFF) | (o & 0xFF)<<8 | (e>>8)<<16 | (o>>8)<<24;
+                }
+            }
+        }
+    }
+
+#ifdef FRAMEGEN_X86
+    //==========
+    // SSE4.1
+    //==========
+    // Lane i of a stream needs stream bytes floor(1.5*i) and the one after it. The masks below gather those bytes
+    // straight from the interleaved words: lanes 0-4 come from words 0-3, lanes 5-7 from words 2-5 (loaded 8 bytes on).
+    FRAMEGEN_TARGET("sse4.1")
+    static void unpack_sse41(const word_t* adcs, adc_t* out) {
+        const __m128i even_lo = _mm_setr_epi8(0, 2, 2, 4, 6, 8, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1);
+        const __m128i even_hi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 6, 8, 10, 12, 12, 14);
+        const __m128i odd_lo = _mm_setr_epi8(1, 3, 3, 5, 7, 9, 9, 11, 13, 15, -1, -1, -1, -1, -1, -1);
+        const __m128i odd_hi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 7, 9, 11, 13, 13, 15);
+        const __m128i mask = _mm_set1_epi16(0xFFF);
+        for(unsigned p=0; p<num_pairs_per_block; p++) {
+            const word_t* w = adcs + p*num_words_per_pair;
+            const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w));
+            const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w+2));
+            __m128i even = _mm_or_si128(_mm_shuffle_epi8(lo, even_lo), _mm_shuffle_epi8(hi, even_hi));
+            __m128i odd = _mm_or_si128(_mm_shuffle_epi8(lo, odd_lo), _mm_shuffle_epi8(hi, odd_hi));
+            // Even channels start on a byte boundary, odd channels four bits later.
+            even = _mm_blend_epi16(_mm_and_si128(even, mask), _mm_srli_epi16(even, 4), 0xAA);
+            odd = _mm_blend_epi16(_mm_and_si128(odd, mask), _mm_srli_epi16(odd, 4), 0xAA);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + p*16), even);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + p*16 + 8), odd);
+        }
+    }
+
+    // Merge each pair of channels into 24 bits of a 32-bit lane and squeeze out the empty fourth bytes.
+    FRAMEGEN_TARGET("sse4.1")
+    static inline __m128i compact_stream(__m128i v) {
+        const __m128i squeeze = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        const __m128i merged = _mm_or_si128(_mm_and_si128(v, _mm_set1_epi32(0xFFF)),
+                                            _mm_and_si128(_mm_srli_epi32(v, 4), _mm_set1_epi32(0xFFF000)));
+        return _mm_shuffle_epi8(merged, squeeze);
+    }
+
+    FRAMEGEN_TARGET("sse4.1")
+    static void pack_sse41(word_t* adcs, const adc_t* in) {
+        for(unsigned p=0; p<num_pairs_per_block; p++) {
+            word_t* w = adcs + p*num_words_per_pair;
+            const __m128i even = compact_stream(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + p*16)));
+            const __m128i odd = compact_stream(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + p*16 + 8)));
+            // Interleaving the two streams byte by byte restores the word layout.
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(w), _mm_unpacklo_epi8(even, odd));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(w+4), _mm_unpackhi_epi8(even, odd));
+        }
+    }
+
+    //========
+    // AVX2
+    //========
+    // Both 128-bit lanes are shuffled at once: the low lane (words 0-3) yields channels 0-3 of both streams, the high
+    // lane (words 2-5) channels 4-7. A 64-bit permute then puts the streams back in order.
+    FRAMEGEN_TARGET("avx2")
+    static void unpack_avx2(const word_t* adcs, adc_t* out) {
+        const __m256i gather = _mm256_setr_epi8(0, 2, 2, 4, 6, 8, 8, 10, 1, 3, 3, 5, 7, 9, 9, 11,
+                                                4, 6, 6, 8, 10, 12, 12, 14, 5, 7, 7, 9, 11, 13, 13, 15);
+        const __m256i mask = _mm256_set1_epi16(0xFFF);
+        for(unsigned p=0; p<num_pairs_per_block; p++) {
+            const word_t* w = adcs + p*num_words_per_pair;
+            __m256i v = _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(w)));
+            v = _mm256_inserti128_si256(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(w+2)), 1);
+            v = _mm256_shuffle_epi8(v, gather);
+            v = _mm256_blend_epi16(_mm256_and_si256(v, mask), _mm256_srli_epi16(v, 4), 0xAA);
+            v = _mm256_permute4x64_epi64(v, 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + p*16), v);
+        }
+    }
+
+    FRAMEGEN_TARGET("avx2")
+    static void pack_avx2(word_t* adcs, const adc_t* in) {
+        const __m256i squeeze = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                                 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        const __m256i low = _mm256_set1_epi32(0xFFF);
+        const __m256i high = _mm256_set1_epi32(0xFFF000);
+        for(unsigned p=0; p<num_pairs_per_block; p++) {
+            word_t* w = adcs + p*num_words_per_pair;
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + p*16));
+            const __m256i merged = _mm256_or_si256(_mm256_and_si256(v, low),
+                                                   _mm256_and_si256(_mm256_srli_epi32(v, 4), high));
+            const __m256i streams = _mm256_shuffle_epi8(merged, squeeze);
+            const __m128i even = _mm256_castsi256_si128(streams);
+            const __m128i odd = _mm256_extracti128_si256(streams, 1);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(w), _mm_unpacklo_epi8(even, odd));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(w+4), _mm_unpackhi_epi8(even, odd));
+        }
+    }
+#endif
+
+    //==========
+    // Dispatch
+    //==========
+    namespace {
+        struct PackKernels {
+            void (*unpack)(const word_t*, adc_t*);
+            void (*pack)(word_t*, const adc_t*);
+            const char* name;
+        };
+
+        PackKernels selectKernels() {
+#ifdef FRAMEGEN_X86
+            if(cpu::supports_avx2()) {
+                PackKernels k = {unpack_avx2, pack_avx2, "avx2"};
+                return k;
+            }
+            if(cpu::supports_sse41()) {
+                PackKernels k = {unpack_sse41, pack_sse41, "sse4.1"};
+                return k;
+            }
+#endif
+            PackKernels k = {unpack_scalar, pack_scalar, "scalar"};
+            return k;
+        }
+
+        const PackKernels& kernels() {
+            static const PackKernels k = selectKernels();
+            return k;
+        }
+    } // namespace
+
+    void unpack_adcs(const word_t* adcs, adc_t out[num_ch_per_block]) { kernels().unpack(adcs, out); }
+    void pack_adcs(word_t* adcs, const adc_t in[num_ch_per_block]) { kernels().pack(adcs, in); }
+
+    void unpack(const ColdataBlock& block, adc_t out[num_ch_per_block]) { unpack_adcs(block.adcs, out); }
+    void pack(ColdataBlock& block, const adc_t in[num_ch_per_block]) { pack_adcs(block.adcs, in); }
+
+    void unpack(const Frame& frame, adc_t out[num_ch_per_frame]) {
+        const PackKernels& k = kernels();
+        for(unsigned i=0; i<4; i++)
+            k.unpack(frame.adcs(i), out + i*num_ch_per_block);
+    }
+
+    void pack(Frame& frame, const adc_t in[num_ch_per_frame]) {
+        const PackKernels& k = kernels();
+        for(unsigned i=0; i<4; i++)
+            k.pack(frame.adcs(i), in + i*num_ch_per_block);
+    }
+
+    const char* pack_kernel() { return kernels().name; }
+
+} // namespace framegen
@@ -0,0 +1,35 @@
+//==========================================================================
+// Name        : Pack.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Bulk packing and unpacking of the 12-bit COLDATA channels.
+//============================================================================
+
+#ifndef FRAMEGEN_PACK_HPP_
+#define FRAMEGEN_PACK_HPP_
+
+#include "FrameGen.hpp"
+
+namespace framegen {
+
+// Bulk channel access. The results are bit-exact with ColdataBlock::channel()
+// and ColdataBlock::set_channel(), but all channels are converted at once.
+// Channels are ordered as adc*8+ch within a block and as block*64+adc*8+ch
+// within a frame, i.e. the same numbering as Frame::channel(ch).
+void unpack(const ColdataBlock& block, adc_t out[num_ch_per_block]);
+void pack(ColdataBlock& block, const adc_t in[num_ch_per_block]);
+
+void unpack(const Frame& frame, adc_t out[num_ch_per_frame]);
+void pack(Frame& frame, const adc_t in[num_ch_per_frame]);
+
+// Same conversions on the raw 24-word ADC area of a COLDATA block.
+void unpack_adcs(const word_t* adcs, adc_t out[num_ch_per_block]);
+void pack_adcs(word_t* adcs, const adc_t in[num_ch_per_block]);
+
+// Name of the kernel selected for this CPU ("avx2", "sse4.1" or "scalar").
+const char* pack_kernel();
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_PACK_HPP_ */
@@ -0,0 +1,178 @@
+//============================================================================
+// Name        : Rans.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Static byte-alphabet rANS entropy coder.
+//============================================================================
+
+#include "src/Rans.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace framegen {
+
+    // Byte-wise renormalisation with 32-bit states, after Fabian Giesen's rans_byte.
+    namespace {
+        const unsigned scale_bits = 12;
+        const uint32_t scale = 1u << scale_bits;
+        const uint32_t rans_l = 1u << 23; // Lower bound of the normalised state.
+
+        enum BlockMode : uint8_t { mode_empty = 0, mode_single = 1, mode_rans = 2 };
+
+        void putVarint(std::vector<uint8_t>& out, uint32_t v) {
+            while(v >= 0x80) {
+                out.push_back((uint8_t)(v | 0x80));
+                v >>= 7;
+            }
+            out.push_back((uint8_t)v);
+        }
+
+        bool getVarint(const uint8_t*& in, const uint8_t* end, uint32_t& v) {
+            v = 0;
+            for(unsigned shift=0; shift<32; shift+=7) {
+                if(in >= end)
+                    return false;
+                const uint8_t b = *in++;
+                v |= (uint32_t)(b & 0x7F) << shift;
+                if(!(b & 0x80))
+                    return true;
+            }
+            return false;
+        }
+
+        // Scale counts to frequencies summing to exactly scale, keeping every used symbol at one or more.
+        void normalise(const uint64_t count[256], const uint64_t total, uint32_t freq[256]) {
+            int64_t sum = 0;
+            unsigned largest = 0;
+            for(unsigned s=0; s<256; s++) {
+                freq[s] = count[s]? std::max<uint64_t>(1, count[s]*scale/total): 0;
+                sum += freq[s];
+                if(count[s] > count[largest])
+                    largest = s;
+            }
+            // Most of the difference goes to the most frequent symbol; otherwise take from whichever can spare it.
+            while(sum != scale) {
+                if(sum < scale) {
+                    freq[largest] += scale - sum;
+                    sum = scale;
+                } else {
+                    unsigned s = largest;
+                    for(unsigned t=0; t<256; t++)
+                        if(freq[t] > freq[s])
+                            s = t;
+                    const uint32_t take = std::min<int64_t>(sum - scale, freq[s] - 1);
+                    freq[s] -= take;
+                    sum -= take;
+                }
+            }
+        }
+
+        inline void encPut(uint32_t& x, uint8_t*& ptr, const uint32_t start, const uint32_t freq) {
+            const uint32_t x_max = ((rans_l >> scale_bits) << 8) * freq;
+            while(x >= x_max) {
+                *--ptr = (uint8_t)x;
+                x >>= 8;
+            }
+            x = ((x / freq) << scale_bits) + (x % freq) + start;
+        }
+    } // namespace
+
+    void rans_encode(const uint8_t* symbols, const size_t n, std::vector<uint8_t>& out) {
+        if(!n) {
+            out.push_back(mode_empty);
+            return;
+        }
+        uint64_t count[256] = {0};
+        for(size_t i=0; i<n; i++)
+            count[symbols[i]]++;
+        if(count[symbols[0]] == n) {
+            out.push_back(mode_single);
+            out.push_back(symbols[0]);
+            return;
+        }
+
+        uint32_t freq[256], start[256];
+        normalise(count, n, freq);
+        out.push_back(mode_rans);
+        for(unsigned s=0, cum=0; s<256; s++) {
+            start[s] = cum;
+            cum += freq[s];
+            putVarint(out, freq[s]);
+        }
+
+        // Symbols are coded back to front so that they decode front to back; symbol i uses state i%4.
+        std::vector<uint8_t> buffer(2*n + 64);
+        uint8_t* const bufEnd = buffer.data() + buffer.size();
+        uint8_t* ptr = bufEnd;
+        uint32_t x[4] = {rans_l, rans_l, rans_l, rans_l};
+        for(size_t i=n; i-->0;) {
+            const uint8_t s = symbols[i];
+            encPut(x[i&3], ptr, start[s], freq[s]);
+        }
+        for(int k=3; k>=0; k--) {
+            ptr -= 4;
+            ptr[0] = x[k];
+            ptr[1] = x[k]>>8;
+            ptr[2] = x[k]>>16;
+            ptr[3] = x[k]>>24;
+        }
+        putVarint(out, bufEnd - ptr);
+        out.insert(out.end(), ptr, bufEnd);
+    }
+
+    bool rans_decode(const uint8_t*& in, const uint8_t* end, uint8_t* symbols, const size_t n) {
+        if(in >= end)
+            return false;
+        const uint8_t mode = *in++;
+        if(mode == mode_empty)
+            return n == 0;
+        if(mode == mode_single) {
+            if(in >= end)
+                return false;
+            memset(symbols, *in++, n);
+            return true;
+        }
+        if(mode != mode_rans)
+            return false;
+
+        uint32_t freq[256], start[256], sum = 0;
+        for(unsigned s=0; s<256; s++) {
+            if(!getVarint(in, end, freq[s]) || freq[s] > scale)
+                return false;
+            start[s] = sum;
+            sum += freq[s];
+        }
+        uint32_t length;
+        if(sum != scale || !getVarint(in, end, length) || length < 16 || length > (size_t)(end - in))
+            return false;
+
+        // Slot to symbol lookup.
+        uint8_t lookup[scale];
+        for(unsigned s=0; s<256; s++)
+            memset(lookup + start[s], s, freq[s]);
+
+        const uint8_t* ptr = in;
+        const uint8_t* const stop = in + length;
+        uint32_t x[4];
+        for(int k=0; k<4; k++, ptr+=4)
+            x[k] = (uint32_t)ptr[0] | (uint32_t)ptr[1]<<8 | (uint32_t)ptr[2]<<16 | (uint32_t)ptr[3]<<24;
+
+        for(size_t i=0; i<n; i++) {
+            uint32_t& xi = x[i&3];
+            const uint32_t slot = xi & (scale-1);
+            const uint8_t s = lookup[slot];
+            symbols[i] = s;
+            xi = freq[s] * (xi >> scale_bits) + slot - start[s];
+            while(xi < rans_l) {
+                if(ptr >= stop)
+                    return false;
+                xi = (xi << 8) | *ptr++;
+            }
+        }
+        in = stop;
+        return true;
+    }
+
+} // namespace framegen
@@ -0,0 +1,33 @@
+//==========================================================================
+// Name        : Rans.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Static byte-alphabet rANS entropy coder.
+//============================================================================
+
+#ifndef FRAMEGEN_RANS_HPP_
+#define FRAMEGEN_RANS_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "Types.hpp"
+
+namespace framegen {
+
+// Order-0 range asymmetric numeral system coder with four interleaved
+// states. Each call codes one self-contained block: the normalised symbol
+// frequencies followed by the coded bytes. Blocks of a single repeated symbol
+// (or none) take two bytes.
+
+// Append the coded form of n symbols to out.
+void rans_encode(const uint8_t* symbols, size_t n, std::vector<uint8_t>& out);
+// Decode n symbols from the block at in, advancing in past it. Returns false
+// if the block is corrupt or runs past end.
+bool rans_decode(const uint8_t*& in, const uint8_t* end, uint8_t* symbols,
+                 size_t n);
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_RANS_HPP_ */
@@ -0,0 +1,188 @@
+//============================================================================
+// Name        : Signal.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Overlay of physics-like pulses on the channel noise.
+//============================================================================
+
+#include "src/Signal.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace framegen {
+
+    namespace {
+        // Largest hit amplitude relative to the pulse peak that is still drawn.
+        const float pulse_cutoff = 0.005f;
+        const unsigned max_track_channels = 128;
+        const double shower_channel_sigma = 4, shower_tick_sigma = 8;
+        const double two_pi = 6.283185307179586;
+        // Poisson means are drawn in parts of at most this, so exp(-part) stays well above underflow.
+        const double poisson_part = 16;
+    } // namespace
+
+    SignalGen::SignalGen(const SignalOptions& options, const uint64_t seed) {
+        setOptions(options);
+        this->seed(seed);
+    }
+
+    void SignalGen::setOptions(const SignalOptions& options) {
+        _options = options;
+        _channels.clear();
+        for(size_t i=0; i<options.channels.size(); i++)
+            if(options.channels[i] < num_ch_per_frame)
+                _channels.push_back(options.channels[i]);
+        if(options.channels.empty())
+            for(unsigned ch=0; ch<num_ch_per_frame; ch++)
+                _channels.push_back(ch);
+
+        // Semi-Gaussian CR-(RC)^4 shaper response, peaking at 1 after peakingTicks.
+        const double tau = std::max(0.5f, options.peakingTicks);
+        _pulse.clear();
+        for(unsigned t=0; t<wheel_ticks; t++) {
+            const double x = t/tau;
+            const float value = std::pow(x, 4)*std::exp(4*(1-x));
+            if(x > 1 && value < pulse_cutoff)
+                break;
+            _pulse.push_back(value);
+        }
+        _started = false;
+    }
+
+    void SignalGen::seed(const uint64_t seed) {
+        _seed = seed;
+        _started = false;
+    }
+
+    // splitmix64: one multiply-xorshift per draw is plenty at event rates.
+    uint64_t SignalGen::next() {
+        uint64_t z = (_state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    double SignalGen::gaussian() {
+        // Box-Muller; the second value is not worth keeping.
+        const double u = 1 - uniform();
+        return std::sqrt(-2*std::log(u))*std::cos(two_pi*uniform());
+    }
+
+    // Knuth's method: count uniforms until their product drops below exp(-mean). Costs about one draw per event.
+    unsigned SignalGen::poisson(double mean) {
+        unsigned n = 0;
+        for(; mean > 0; mean -= poisson_part) {
+            const double limit = std::exp(-std::min(mean, poisson_part));
+            for(double p=uniform(); p > limit; p *= uniform())
+                n++;
+        }
+        return n;
+    }
+
+    void SignalGen::schedule(const unsigned index, const uint64_t delay, const float amplitude) {
+        Hit hit;
+        hit.channel = _channels[index];
+        hit.position = 0;
+        hit.amplitude = amplitude;
+        _wheel[(_tick + std::min<uint64_t>(delay, wheel_ticks-1)) % wheel_ticks].push_back(hit);
+        _stats.hits++;
+    }
+
+    void SignalGen::spawnHit() {
+        schedule(uniform()*_channels.size(), 0, _options.hitAmplitude*(0.5 + uniform()));
+    }
+
+    // A straight line through the wire plane: consecutive channels, each hit a fixed number of ticks after the last.
+    void SignalGen::spawnTrack() {
+        const unsigned maxLength = std::min<size_t>(_channels.size(), max_track_channels);
+        const unsigned length = 1 + uniform()*maxLength;
+        const unsigned first = uniform()*(_channels.size() - length + 1);
+        double slope = gaussian();
+        if(std::fabs(slope)*length > wheel_ticks-1)
+            slope *= (wheel_ticks-1)/(std::fabs(slope)*length);
+        const double start = slope < 0 ? -slope*(length-1) : 0;
+        for(unsigned k=0; k<length; k++)
+            schedule(first+k, std::lround(start + slope*k), _options.trackAmplitude*(0.8 + 0.4*uniform()));
+    }
+
+    // Many hits scattered around a centre, falling off with distance from it.
+    void SignalGen::spawnShower() {
+        const int centre = uniform()*_channels.size();
+        const unsigned Nhits = 20 + uniform()*60;
+        for(unsigned h=0; h<Nhits; h++) {
+            const double offset = gaussian()*shower_channel_sigma;
+            const int index = std::max(0, std::min<int>(_channels.size()-1, centre + std::lround(offset)));
+            const float amplitude = _options.showerAmplitude*std::exp(-offset*offset/(2*shower_channel_sigma*shower_channel_sigma))*(0.5 + uniform());
+            schedule(index, std::lround(std::fabs(gaussian())*shower_tick_sigma), amplitude);
+        }
+    }
+
+    void SignalGen::startTick() {
+        if(!_channels.empty() && (!_options.windowPeriod || _tick % _options.windowPeriod < _options.windowLength)) {
+            // Nothing carries over from earlier ticks, so a replay draws exactly the same events.
+            _state = _seed ^ _tick;
+            _state = next();
+            const unsigned Nhits = poisson(_options.hitRate);
+            const unsigned Ntracks = poisson(_options.trackRate);
+            const unsigned Nshowers = poisson(_options.showerRate);
+            for(unsigned n=0; n<Nhits; n++)
+                spawnHit();
+            for(unsigned n=0; n<Ntracks; n++)
+                spawnTrack();
+            for(unsigned n=0; n<Nshowers; n++)
+                spawnShower();
+            _stats.events += Nhits + Ntracks + Nshowers;
+        }
+        std::vector<Hit>& due = _wheel[_tick % wheel_ticks];
+        _active.insert(_active.end(), due.begin(), due.end());
+        due.clear();
+    }
+
+    void SignalGen::restart(const uint64_t tick) {
+        for(unsigned t=0; t<wheel_ticks; t++)
+            _wheel[t].clear();
+        _active.clear();
+
+        // Replay the ticks whose events can still reach this one, without counting them.
+        const Stats stats = _stats;
+        const uint64_t replay = wheel_ticks + _pulse.size();
+        for(_tick = tick > replay ? tick-replay : 0; _tick < tick; _tick++) {
+            startTick();
+            for(size_t i=0; i<_active.size(); ) {
+                if(++_active[i].position >= _pulse.size()) {
+                    _active[i] = _active.back();
+                    _active.pop_back();
+                } else {
+                    i++;
+                }
+            }
+        }
+        _stats = stats;
+        _started = true;
+    }
+
+    void SignalGen::apply(adc_t adcs[num_ch_per_frame], const uint64_t tick) {
+        if(!_started || tick != _tick+1)
+            restart(tick);
+        else
+            _tick = tick;
+        startTick();
+
+        _stats.samples += _active.size();
+        for(size_t i=0; i<_active.size(); ) {
+            Hit& hit = _active[i];
+            const int value = adcs[hit.channel] + (int)(hit.amplitude*_pulse[hit.position] + 0.5f);
+            adcs[hit.channel] = std::max(0, std::min(4095, value));
+            if(++hit.position >= _pulse.size()) {
+                hit = _active.back();
+                _active.pop_back();
+            } else {
+                i++;
+            }
+        }
+        _stats.frames++;
+    }
+
+} // namespace framegen
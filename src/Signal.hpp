@@ -0,0 +1,125 @@
+//==========================================================================
+// Name        : Signal.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Overlay of physics-like pulses on the channel noise.
+//============================================================================
+
+#ifndef FRAMEGEN_SIGNAL_HPP_
+#define FRAMEGEN_SIGNAL_HPP_
+
+#include <vector>
+
+#include "Types.hpp"
+
+namespace framegen {
+
+// Rates are mean numbers of new events per frame (tick) over the selected
+// channels; amplitudes are pulse peaks in ADC counts.
+struct SignalOptions {
+  double hitRate = 0;     // Isolated single-channel hits.
+  double trackRate = 0;   // Straight tracks over many adjacent channels.
+  double showerRate = 0;  // Clusters of hits spread in channel and time.
+  float hitAmplitude = 80;
+  float trackAmplitude = 50;  // Per channel.
+  float showerAmplitude = 150;
+
+  // Pulse shaping time: ticks from the start of a pulse to its peak.
+  float peakingTicks = 4;
+
+  // Channels that can receive signal, as indices of Frame::channel(ch).
+  // Neighbouring entries are taken as neighbouring wires. Empty means all.
+  std::vector<unsigned> channels;
+  // Events only start in the first windowLength ticks of every windowPeriod
+  // ticks, e.g. beam spills. A zero period means always.
+  uint64_t windowPeriod = 0;
+  uint64_t windowLength = 0;
+
+  bool enabled() const { return hitRate > 0 || trackRate > 0 || showerRate > 0; }
+};
+
+// ==================================================================
+// Adds pulses to one stream of frames. Every event is a set of hits, each a
+// precomputed pulse template scaled to an amplitude on one channel from a
+// given tick on. Hits waiting to start sit on a timing wheel and running
+// hits on an active list, so the work per frame scales with the number of
+// hits rather than the number of channels.
+//
+// Ticks count the frames of the generator's own stream, not timestamps, so
+// other generators claiming from the same clock do not break the timeline.
+// The events starting at a tick are drawn from a stream seeded by the seed
+// and the tick alone. Hits span several frames, so apply() expects
+// consecutive ticks; on a jump (the first frame, or a worker thread moving on
+// to its next batch) the state is rebuilt by replaying the events of the
+// preceding wheel_ticks plus a pulse length of ticks. The replay is exact, so
+// generators with the same seed produce the same signal however the ticks
+// are split between them, at the cost of about that many frames' worth of
+// signal per jump.
+// ==================================================================
+class SignalGen {
+ public:
+  struct Stats {
+    uint64_t frames = 0;
+    uint64_t events = 0;
+    uint64_t hits = 0;
+    uint64_t samples = 0;  // ADC samples changed.
+
+    // Fraction of channel samples carrying signal.
+    double occupancy() const {
+      return frames ? (double)samples / (frames * num_ch_per_frame) : 0;
+    }
+  };
+
+ private:
+  struct Hit {
+    uint16_t channel;
+    uint16_t position;  // Next template sample.
+    float amplitude;
+  };
+  static const unsigned wheel_ticks = 256;
+
+  SignalOptions _options;
+  std::vector<unsigned> _channels;
+  std::vector<float> _pulse;
+  std::vector<Hit> _wheel[wheel_ticks];  // Hits starting at tick % wheel_ticks.
+  std::vector<Hit> _active;
+  uint64_t _tick = 0;
+  bool _started = false;
+  uint64_t _seed = 0;
+  uint64_t _state = 0;
+  Stats _stats;
+
+  uint64_t next();
+  double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+  double gaussian();
+  unsigned poisson(double mean);
+
+  void schedule(unsigned index, uint64_t delay, float amplitude);
+  void spawnHit();
+  void spawnTrack();
+  void spawnShower();
+  // Start the events due at the current tick and move due hits to the active list.
+  void startTick();
+  void restart(uint64_t tick);
+
+ public:
+  explicit SignalGen(const SignalOptions& options = SignalOptions(),
+                     uint64_t seed = 0);
+
+  void setOptions(const SignalOptions& options);
+  const SignalOptions& options() const { return _options; }
+  void seed(uint64_t seed);
+  uint64_t seed() const { return _seed; }
+
+  // Add the signal of frame number tick of the stream to its samples,
+  // clamped to the 12-bit ADC range.
+  void apply(adc_t adcs[num_ch_per_frame], uint64_t tick);
+
+  const Stats& stats() const { return _stats; }
+  void resetStats() { _stats = Stats(); }
+};
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_SIGNAL_HPP_ */
@@ -0,0 +1,197 @@
+//============================================================================
+// Name        : TextWriter.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Fast text renderings of frames.
+//============================================================================
+
+#include "src/TextWriter.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace framegen {
+
+    namespace {
+        // Two digits per lookup: hexadecimal bytes, octal pairs of three bits and decimal 00 to 99.
+        struct DigitTables {
+            char hex[256][2];
+            char oct[64][2];
+            char dec[100][2];
+
+            DigitTables() {
+                const char* digits = "0123456789abcdef";
+                for(unsigned i=0; i<256; i++) {
+                    hex[i][0] = digits[i >> 4];
+                    hex[i][1] = digits[i & 0xf];
+                }
+                for(unsigned i=0; i<64; i++) {
+                    oct[i][0] = '0' + (i >> 3);
+                    oct[i][1] = '0' + (i & 7);
+                }
+                for(unsigned i=0; i<100; i++) {
+                    dec[i][0] = '0' + i/10;
+                    dec[i][1] = '0' + i%10;
+                }
+            }
+        };
+        const DigitTables tables;
+
+        // Eight hexadecimal digits.
+        inline char* putHex(char* p, const word_t w) {
+            memcpy(p, tables.hex[w >> 24], 2);
+            memcpy(p+2, tables.hex[(w >> 16) & 0xff], 2);
+            memcpy(p+4, tables.hex[(w >> 8) & 0xff], 2);
+            memcpy(p+6, tables.hex[w & 0xff], 2);
+            return p+8;
+        }
+
+        // Eleven octal digits: the top two bits, then five pairs of three.
+        inline char* putOct(char* p, const word_t w) {
+            *p++ = '0' + (w >> 30);
+            for(int shift=24; shift>=0; shift-=6, p+=2)
+                memcpy(p, tables.oct[(w >> shift) & 0x3f], 2);
+            return p;
+        }
+
+        // Ten decimal digits.
+        inline char* putDec(char* p, word_t w) {
+            const word_t high = w / 100000000;
+            w %= 100000000;
+            memcpy(p, tables.dec[high], 2);
+            memcpy(p+2, tables.dec[w / 1000000], 2);
+            memcpy(p+4, tables.dec[w / 10000 % 100], 2);
+            memcpy(p+6, tables.dec[w / 100 % 100], 2);
+            memcpy(p+8, tables.dec[w % 100], 2);
+            return p+10;
+        }
+
+        const char header_word_prefix[] = ",\n    0x";
+        const char header_footer[] = "\n};\n\n#endif";
+    } // namespace
+
+    bool isTextFormat(const char opt) { return opt=='h' || opt=='o' || opt=='d' || opt=='f'; }
+
+    size_t formatFrame(const ConstFrameView& frame, const char opt, char* out, const bool first) {
+        const word_t* words = frame.data();
+        char* p = out;
+        switch(opt) {
+            case 'h':
+                for(unsigned i=0; i<num_frame_words; i++) {
+                    p[0] = '0';
+                    p[1] = 'x';
+                    p = putHex(p+2, words[i]);
+                    *p++ = '\n';
+                }
+                break;
+            case 'o':
+                for(unsigned i=0; i<num_frame_words; i++) {
+                    *p++ = '0';
+                    p = putOct(p, words[i]);
+                    *p++ = '\n';
+                }
+                break;
+            case 'd':
+                for(unsigned i=0; i<num_frame_words; i++) {
+                    p = putDec(p, words[i]);
+                    *p++ = '\n';
+                }
+                break;
+            case 'f':
+                for(unsigned i=0; i<num_frame_words; i++) {
+                    // The very first word of the array has no comma before it.
+                    const size_t skip = (first && !i) ? 1 : 0;
+                    memcpy(p, header_word_prefix+skip, sizeof(header_word_prefix)-1-skip);
+                    p = putHex(p + sizeof(header_word_prefix)-1-skip, words[i]);
+                }
+                break;
+            default:
+                return 0;
+        }
+        return p - out;
+    }
+
+    std::string textHeader(const char opt, const unsigned long Nframes) {
+        if(opt != 'f')
+            return "";
+        std::ostringstream header;
+        header << "#ifndef PROTODUNE_H__\n#define PROTODUNE_H__\n\n"
+            << "const uint32_t PROTODUNE_FRAMESIZE = 117*4;\n"
+            << "const uint32_t PROTODUNE_FRAMENUM = " << Nframes << ";\n\n"
+            << "uint32_t PROTODUNE_DATA[] = {";
+        return header.str();
+    }
+
+    std::string textFooter(const char opt) { return opt=='f' ? header_footer : ""; }
+
+    //============
+    // TextWriter
+    //============
+    bool TextWriter::open(const std::string& filename, const char opt, const unsigned long Nframes) {
+        close();
+        if(!isTextFormat(opt)) {
+            std::cout << "Error (TextWriter::open()): unknown text format '" << opt << "'." << std::endl;
+            return false;
+        }
+        _opt = opt;
+        _frames = 0;
+        _fill = 0;
+        _buffer.resize(std::max(_bufferBytes, max_text_frame_chars));
+        // Whole buffers go past the writer's own buffer in a single write().
+        _writer.setBufferSize(FrameWriter::alignment);
+        if(!_writer.open(filename))
+            return false;
+        const std::string header = textHeader(opt, Nframes);
+        memcpy(_buffer.data(), header.data(), header.size());
+        _fill = header.size();
+        return true;
+    }
+
+    bool TextWriter::flushBuffer() {
+        const size_t fill = _fill;
+        _fill = 0;
+        return _writer.write(_buffer.data(), fill);
+    }
+
+    bool TextWriter::write(const ConstFrameView& frame) {
+        if(!good())
+            return false;
+        if(_buffer.size() - _fill < max_text_frame_chars && !flushBuffer())
+            return false;
+        _fill += formatFrame(frame, _opt, _buffer.data()+_fill, !_frames);
+        _frames++;
+        return true;
+    }
+
+    bool TextWriter::write(const Frame* frames, const size_t Nframes) {
+        for(size_t i=0; i<Nframes; i++)
+            if(!write(frames[i]))
+                return false;
+        return true;
+    }
+
+    bool TextWriter::flush() {
+        if(!is_open())
+            return false;
+        return flushBuffer() && _writer.flush();
+    }
+
+    bool TextWriter::close() {
+        if(!is_open())
+            return true;
+        const std::string footer = textFooter(_opt);
+        bool ok = good();
+        if(ok && _buffer.size() - _fill < footer.size())
+            ok = flushBuffer();
+        if(ok) {
+            memcpy(_buffer.data()+_fill, footer.data(), footer.size());
+            _fill += footer.size();
+            ok = flushBuffer();
+        }
+        _fill = 0;
+        return _writer.close() && ok;
+    }
+
+} // namespace framegen
@@ -0,0 +1,88 @@
+//==========================================================================
+// Name        : TextWriter.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Fast text renderings of frames.
+//============================================================================
+
+#ifndef FRAMEGEN_TEXTWRITER_HPP_
+#define FRAMEGEN_TEXTWRITER_HPP_
+
+#include <string>
+#include <vector>
+
+#include "FrameGen.hpp"
+#include "FrameWriter.hpp"
+
+namespace framegen {
+
+// Text formats, one word per line:
+//   'h' hexadecimal, "0x%08x"
+//   'o' octal, "0%011o"
+//   'd' decimal, "%010u"
+//   'f' a C header declaring the words as the array PROTODUNE_DATA.
+bool isTextFormat(char opt);
+
+// Upper bound of the characters formatFrame() writes for one frame.
+static const size_t max_text_frame_chars = num_frame_words * 16;
+
+// Write the words of a frame at out and return the number of characters
+// written. Digits come from lookup tables rather than a stream. In the 'f'
+// format every word but the first of the file follows a comma, so first says
+// whether this frame starts the array.
+size_t formatFrame(const ConstFrameView& frame, char opt, char* out,
+                   bool first = true);
+// Text before the first and after the last frame. Only 'f' has any.
+std::string textHeader(char opt, unsigned long Nframes);
+std::string textFooter(char opt);
+
+// ==================================================================
+// Sink for files of frames in one of the text formats. Frames are formatted
+// straight into a large buffer that goes to the file as a whole once full, and
+// the 'f' header and footer are written once, at open() and close().
+// ==================================================================
+class TextWriter {
+ private:
+  FrameWriter _writer;
+  std::vector<char> _buffer;
+  size_t _fill = 0;
+  size_t _bufferBytes = default_buffer_bytes;
+  char _opt = 'h';
+  unsigned long _frames = 0;
+
+  bool flushBuffer();
+
+ public:
+  static const size_t default_buffer_bytes = 1 << 20;
+
+  TextWriter() {}
+  ~TextWriter() { close(); }
+  TextWriter(const TextWriter&) = delete;
+  TextWriter& operator=(const TextWriter&) = delete;
+
+  // Used by the next open(); never less than one frame.
+  void setBufferSize(size_t bytes) { _bufferBytes = bytes; }
+
+  // Open a file, truncating it. For 'f' the header announces Nframes frames.
+  bool open(const std::string& filename, char opt,
+            unsigned long Nframes = 1);
+  // Write the footer and all buffered text and close the file.
+  bool close();
+
+  bool is_open() const { return _writer.is_open(); }
+  bool good() const { return _writer.good(); }
+  const std::string& filename() const { return _writer.filename(); }
+  char format() const { return _opt; }
+  unsigned long frames() const { return _frames; }
+
+  bool write(const ConstFrameView& frame);
+  bool write(const Frame* frames, size_t Nframes);
+
+  // Hand the buffered text to the operating system.
+  bool flush();
+};
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_TEXTWRITER_HPP_ */
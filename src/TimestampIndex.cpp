@@ -0,0 +1,179 @@
+//============================================================================
+// Name        : TimestampIndex.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Timestamp lookup for files of consecutive frames.
+//============================================================================
+
+#include "src/TimestampIndex.hpp"
+#include "src/FrameFile.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace framegen {
+
+    namespace {
+        inline void put16(uint8_t* p, uint16_t v) { p[0] = v; p[1] = v>>8; }
+        inline void put32(uint8_t* p, uint32_t v) { put16(p, v); put16(p+2, v>>16); }
+        inline void put64(uint8_t* p, uint64_t v) { put32(p, v); put32(p+4, v>>32); }
+        inline uint16_t get16(const uint8_t* p) { return (uint16_t)(p[0] | p[1]<<8); }
+        inline uint32_t get32(const uint8_t* p) { return get16(p) | (uint32_t)get16(p+2)<<16; }
+        inline uint64_t get64(const uint8_t* p) { return get32(p) | (uint64_t)get32(p+4)<<32; }
+
+        // magic, version, periodic flag, stride, frames, period, gaps, out-of-order count, samples.
+        const size_t sidecar_header_bytes = 56;
+    } // namespace
+
+    bool TimestampIndex::build(const FrameFile& file, const TimestampIndexOptions& options) {
+        *this = TimestampIndex();
+        if(!file.is_open()) {
+            std::cout << "Error (TimestampIndex::build()): the file is not open." << std::endl;
+            return false;
+        }
+        _stride = std::max<size_t>(options.stride, 1);
+        _Nframes = file.size();
+        _period = options.period;
+        _samples.reserve(_Nframes/_stride + 1);
+        file.adviseSequential();
+
+        bool periodic = _Nframes > 1;
+        uint64_t previous = 0;
+        std::vector<Frame> buffer;
+        for(uint64_t first=0; first<_Nframes; first+=FrameFile::window_frames) {
+            const size_t count = std::min<uint64_t>(FrameFile::window_frames, _Nframes-first);
+            const word_t* words = file.frames(first, count, buffer);
+            if(!words)
+                return false;
+            for(size_t i=0; i<count; i++) {
+                const uint64_t frame = first+i;
+                const uint64_t timestamp = ConstFrameView(words + i*num_frame_words).timestamp();
+                if(frame % _stride == 0)
+                    _samples.push_back(timestamp);
+                if(frame == 1 && !_period)
+                    _period = timestamp > previous ? timestamp - previous : 0;
+                if(frame > 0) {
+                    const bool late = timestamp > previous && timestamp - previous > _period;
+                    if(timestamp - previous != _period)
+                        periodic = false;
+                    if(late || timestamp <= previous) {
+                        late ? _gaps++ : _outOfOrder++;
+                        if(_anomalies.size() < options.maxAnomalies) {
+                            TimestampAnomaly anomaly;
+                            anomaly.kind = late ? TimestampAnomaly::gap : TimestampAnomaly::out_of_order;
+                            anomaly.frame = frame;
+                            anomaly.previous = previous;
+                            anomaly.timestamp = timestamp;
+                            _anomalies.push_back(anomaly);
+                        }
+                    }
+                }
+                previous = timestamp;
+            }
+        }
+        _periodic = periodic && _period > 0;
+        return true;
+    }
+
+    bool TimestampIndex::build(const std::string& filename, const TimestampIndexOptions& options) {
+        FrameFile file(filename);
+        return file.is_open() && build(file, options);
+    }
+
+    bool TimestampIndex::save(const std::string& filename) const {
+        std::vector<uint8_t> buf(sidecar_header_bytes + 8*_samples.size());
+        put32(&buf[0], magic);
+        put16(&buf[4], current_version);
+        buf[6] = _periodic;
+        put64(&buf[8], _stride);
+        put64(&buf[16], _Nframes);
+        put64(&buf[24], _period);
+        put64(&buf[32], _gaps);
+        put64(&buf[40], _outOfOrder);
+        put64(&buf[48], _samples.size());
+        for(size_t i=0; i<_samples.size(); i++)
+            put64(&buf[sidecar_header_bytes + 8*i], _samples[i]);
+
+        std::ofstream out(filename, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(buf.data()), buf.size());
+        out.close();
+        if(out.fail()) {
+            std::cout << "Error (TimestampIndex::save()): file " << filename << " could not be written." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool TimestampIndex::load(const std::string& filename) {
+        std::ifstream in(filename, std::ios::binary);
+        in.seekg(0, std::ios::end);
+        const std::streamoff bytes = in.tellg();
+        in.seekg(0, std::ios::beg);
+        uint8_t head[sidecar_header_bytes];
+        if(!in.read(reinterpret_cast<char*>(head), sizeof(head)) || get32(head) != magic
+           || get16(head+4) > current_version) {
+            return false;
+        }
+        TimestampIndex index;
+        index._periodic = head[6];
+        index._stride = get64(head+8);
+        index._Nframes = get64(head+16);
+        index._period = get64(head+24);
+        index._gaps = get64(head+32);
+        index._outOfOrder = get64(head+40);
+        const uint64_t Nsamples = get64(head+48);
+        // Checked against the length of the sidecar before anything is allocated for the samples.
+        if(!index._stride || Nsamples != (index._Nframes + index._stride - 1) / index._stride
+           || Nsamples > (uint64_t)(bytes - sidecar_header_bytes) / 8)
+            return false;
+
+        std::vector<uint8_t> buf(8*Nsamples);
+        if(!in.read(reinterpret_cast<char*>(buf.data()), buf.size()))
+            return false;
+        index._samples.resize(Nsamples);
+        for(size_t i=0; i<Nsamples; i++)
+            index._samples[i] = get64(&buf[8*i]);
+        *this = index;
+        return true;
+    }
+
+    bool TimestampIndex::open(const FrameFile& file, const TimestampIndexOptions& options) {
+        const std::string sidecar = file.filename() + ".tsidx";
+        // The sidecar matches if it was made with the same stride and period, has the same length and agrees on
+        // the first and last sampled frames. Without a given period, it is the step between the first two frames.
+        uint64_t period = options.period;
+        if(!period && file.size() > 1) {
+            const uint64_t t0 = file.frame(0).timestamp(), t1 = file.frame(1).timestamp();
+            period = t1 > t0 ? t1 - t0 : 0;
+        }
+        if(load(sidecar) && _stride == std::max<size_t>(options.stride, 1) && _period == period
+           && _Nframes == file.size()
+           && (!_Nframes || (file.frame(0).timestamp() == _samples.front()
+                             && file.frame((_samples.size()-1)*_stride).timestamp() == _samples.back())))
+            return true;
+        return build(file, options) && save(sidecar);
+    }
+
+    uint64_t TimestampIndex::lowerBound(const FrameFile& file, const uint64_t t) const {
+        if(_samples.empty() || t <= _samples[0])
+            return 0;
+        if(_periodic)
+            return std::min(_Nframes, (t - _samples[0] + _period - 1) / _period);
+
+        // The kept frame at or after t bounds the search; the frames since the previous kept one are searched.
+        const size_t k = std::lower_bound(_samples.begin(), _samples.end(), t) - _samples.begin();
+        uint64_t lo = (k-1)*_stride + 1;
+        uint64_t hi = std::min<uint64_t>(k*_stride, _Nframes);
+        while(lo < hi) {
+            const uint64_t mid = lo + (hi-lo)/2;
+            if(file.frame(mid).timestamp() < t)
+                lo = mid+1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+} // namespace framegen
@@ -0,0 +1,102 @@
+//==========================================================================
+// Name        : TimestampIndex.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Timestamp lookup for files of consecutive frames.
+//============================================================================
+
+#ifndef FRAMEGEN_TIMESTAMPINDEX_HPP_
+#define FRAMEGEN_TIMESTAMPINDEX_HPP_
+
+#include <string>
+#include <vector>
+
+#include "Types.hpp"
+
+namespace framegen {
+
+class FrameFile;
+
+// A place where the timestamps of consecutive frames do not advance by the
+// expected period.
+struct TimestampAnomaly {
+  enum Kind { gap, out_of_order };
+
+  Kind kind;
+  uint64_t frame;     // Index of the frame after the anomaly.
+  uint64_t previous;  // Timestamps of the frames on either side.
+  uint64_t timestamp;
+};
+
+struct TimestampIndexOptions {
+  // Keep the timestamp of every stride-th frame. Lookups read at most
+  // stride-1 further frames from the file, so large strides make small
+  // indices for huge files at little cost.
+  size_t stride = 64;
+  // Expected timestamp step between frames. Zero takes the step between the
+  // first two frames.
+  uint64_t period = 0;
+  // Anomalies beyond this number are only counted.
+  size_t maxAnomalies = 1000;
+};
+
+// ==================================================================
+// Sparse index from timestamps to frame positions, built in one pass over a
+// frame file. If every frame follows the previous one by exactly the period
+// the index is periodic and lookups are computed without touching the file;
+// otherwise they binary-search the kept timestamps and then the frames in
+// between. Lookups assume timestamps that increase through the file; with
+// out-of-order frames they return a valid but not necessarily first match.
+// ==================================================================
+class TimestampIndex {
+ private:
+  size_t _stride = 1;
+  uint64_t _Nframes = 0;
+  uint64_t _period = 0;
+  bool _periodic = false;
+  std::vector<uint64_t> _samples;  // Timestamps of frames 0, stride, ...
+  std::vector<TimestampAnomaly> _anomalies;
+  uint64_t _gaps = 0, _outOfOrder = 0;
+
+ public:
+  static const uint32_t magic = 0x49544746;  // "FGTI" in file order.
+  static const uint16_t current_version = 1;
+
+  // Scan a frame file once.
+  bool build(const FrameFile& file,
+             const TimestampIndexOptions& options = TimestampIndexOptions());
+  bool build(const std::string& filename,
+             const TimestampIndexOptions& options = TimestampIndexOptions());
+
+  // Sidecar files, conventionally the frame file's name plus ".tsidx". The
+  // anomalies themselves are not stored, only their counts, so anomalies() is
+  // empty after a load.
+  bool save(const std::string& filename) const;
+  bool load(const std::string& filename);
+  // Load the sidecar of a frame file if it matches the file and the stride
+  // and period of the options, otherwise build the index and write the
+  // sidecar. Call build() instead when the list of anomalies is needed.
+  bool open(const FrameFile& file,
+            const TimestampIndexOptions& options = TimestampIndexOptions());
+
+  // Index of the first frame with a timestamp at or after t, or size() if
+  // there is none. The file is only read for non-periodic indices and must
+  // be the one the index was built from.
+  uint64_t lowerBound(const FrameFile& file, uint64_t t) const;
+
+  uint64_t size() const { return _Nframes; }
+  size_t stride() const { return _stride; }
+  bool periodic() const { return _periodic; }
+  uint64_t period() const { return _period; }
+  uint64_t firstTimestamp() const { return _samples.empty() ? 0 : _samples[0]; }
+  const std::vector<uint64_t>& samples() const { return _samples; }
+
+  const std::vector<TimestampAnomaly>& anomalies() const { return _anomalies; }
+  uint64_t gaps() const { return _gaps; }
+  uint64_t outOfOrder() const { return _outOfOrder; }
+};
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_TIMESTAMPINDEX_HPP_ */
@@ -0,0 +1,271 @@
+//============================================================================
+// Name        : Transpose.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Conversion between frames and channel-major sample arrays.
+//============================================================================
+
+#include "src/Transpose.hpp"
+#include "src/Cpu.hpp"
+#include "src/Pack.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace framegen {
+
+    namespace {
+        // Frames per tile: 64 samples of a channel fill two cache lines of its row, and the unpacked tile (32 kB)
+        // stays in cache.
+        const unsigned tile_frames = 64;
+        // Matrices from this size on are written with streaming stores where possible.
+        const size_t stream_bytes = 8 << 20;
+
+        // The kernels move samples between a tile, one row of num_ch_per_frame samples per frame, and Nframes
+        // (at most tile_frames) columns of the matrix.
+        typedef void (*to_channels_fn)(const adc_t* tile, unsigned Nframes, adc_t* matrix, size_t stride);
+        typedef void (*to_frames_fn)(const adc_t* matrix, size_t stride, unsigned Nframes, adc_t* tile);
+
+        //========
+        // Scalar
+        //========
+        void toChannelsScalar(const adc_t* tile, const unsigned Nframes, adc_t* matrix, const size_t stride) {
+            for(unsigned ch=0; ch<num_ch_per_frame; ch++)
+                for(unsigned f=0; f<Nframes; f++)
+                    matrix[ch*stride + f] = tile[f*num_ch_per_frame + ch];
+        }
+
+        void toFramesScalar(const adc_t* matrix, const size_t stride, const unsigned Nframes, adc_t* tile) {
+            for(unsigned f=0; f<Nframes; f++)
+                for(unsigned ch=0; ch<num_ch_per_frame; ch++)
+                    tile[f*num_ch_per_frame + ch] = matrix[ch*stride + f];
+        }
+
+#ifdef FRAMEGEN_X86
+        //========
+        // SSE4.1
+        //========
+        // Transpose the 8x8 block of 16-bit samples at in (rows inStride apart) to out (rows outStride apart), in
+        // three rounds of interleaving: pairs, then pairs of pairs, then halves.
+        FRAMEGEN_TARGET("sse4.1")
+        inline void block8x8(const adc_t* in, const size_t inStride, adc_t* out, const size_t outStride) {
+            __m128i r[8], t[8];
+            for(unsigned i=0; i<8; i++)
+                r[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i*inStride));
+            for(unsigned i=0; i<8; i+=2) {
+                t[i] = _mm_unpacklo_epi16(r[i], r[i+1]);
+                t[i+1] = _mm_unpackhi_epi16(r[i], r[i+1]);
+            }
+            for(unsigned i=0; i<8; i+=4) {
+                r[i] = _mm_unpacklo_epi32(t[i], t[i+2]);
+                r[i+1] = _mm_unpackhi_epi32(t[i], t[i+2]);
+                r[i+2] = _mm_unpacklo_epi32(t[i+1], t[i+3]);
+                r[i+3] = _mm_unpackhi_epi32(t[i+1], t[i+3]);
+            }
+            for(unsigned i=0; i<4; i++) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2*i*outStride), _mm_unpacklo_epi64(r[i], r[i+4]));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (2*i+1)*outStride), _mm_unpackhi_epi64(r[i], r[i+4]));
+            }
+        }
+
+        FRAMEGEN_TARGET("sse4.1")
+        void toChannelsSSE41(const adc_t* tile, const unsigned Nframes, adc_t* matrix, const size_t stride) {
+            const unsigned full = Nframes/8*8;
+            for(unsigned ch=0; ch<num_ch_per_frame; ch+=8)
+                for(unsigned f=0; f<full; f+=8)
+                    block8x8(tile + f*num_ch_per_frame + ch, num_ch_per_frame, matrix + ch*stride + f, stride);
+            for(unsigned ch=0; ch<num_ch_per_frame; ch++)
+                for(unsigned f=full; f<Nframes; f++)
+                    matrix[ch*stride + f] = tile[f*num_ch_per_frame + ch];
+        }
+
+        FRAMEGEN_TARGET("sse4.1")
+        void toFramesSSE41(const adc_t* matrix, const size_t stride, const unsigned Nframes, adc_t* tile) {
+            const unsigned full = Nframes/8*8;
+            for(unsigned f=0; f<full; f+=8)
+                for(unsigned ch=0; ch<num_ch_per_frame; ch+=8)
+                    block8x8(matrix + ch*stride + f, stride, tile + f*num_ch_per_frame + ch, num_ch_per_frame);
+            for(unsigned f=full; f<Nframes; f++)
+                for(unsigned ch=0; ch<num_ch_per_frame; ch++)
+                    tile[f*num_ch_per_frame + ch] = matrix[ch*stride + f];
+        }
+
+        // Copy whole tiles of channel rows to the matrix with non-temporal stores. The cache lines of every row are
+        // written in one go, so each write-combining buffer is filled completely and the lines are never read.
+        FRAMEGEN_TARGET("sse4.1")
+        void streamRowsSSE41(const adc_t* rows, adc_t* matrix, const size_t stride) {
+            for(unsigned ch=0; ch<num_ch_per_frame; ch++) {
+                const __m128i* in = reinterpret_cast<const __m128i*>(rows + ch*tile_frames);
+                __m128i* out = reinterpret_cast<__m128i*>(matrix + ch*stride);
+                for(unsigned i=0; i<tile_frames*sizeof(adc_t)/16; i++)
+                    _mm_stream_si128(out+i, _mm_load_si128(in+i));
+            }
+            _mm_sfence();
+        }
+
+        //======
+        // AVX2
+        //======
+        // The same shuffles work within each 128-bit lane, so one pass transposes two 8x8 blocks side by side: 8
+        // rows of 16 samples in become 16 rows of 8 samples out, the left block's rows first.
+        FRAMEGEN_TARGET("avx2")
+        inline void block8x16(const adc_t* in, const size_t inStride, adc_t* out, const size_t outStride) {
+            __m256i r[8], t[8];
+            for(unsigned i=0; i<8; i++)
+                r[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i*inStride));
+            for(unsigned i=0; i<8; i+=2) {
+                t[i] = _mm256_unpacklo_epi16(r[i], r[i+1]);
+                t[i+1] = _mm256_unpackhi_epi16(r[i], r[i+1]);
+            }
+            for(unsigned i=0; i<8; i+=4) {
+                r[i] = _mm256_unpacklo_epi32(t[i], t[i+2]);
+                r[i+1] = _mm256_unpackhi_epi32(t[i], t[i+2]);
+                r[i+2] = _mm256_unpacklo_epi32(t[i+1], t[i+3]);
+                r[i+3] = _mm256_unpackhi_epi32(t[i+1], t[i+3]);
+            }
+            for(unsigned i=0; i<4; i++) {
+                const __m256i even = _mm256_unpacklo_epi64(r[i], r[i+4]);
+                const __m256i odd = _mm256_unpackhi_epi64(r[i], r[i+4]);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2*i*outStride), _mm256_castsi256_si128(even));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (2*i+1)*outStride), _mm256_castsi256_si128(odd));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (2*i+8)*outStride), _mm256_extracti128_si256(even, 1));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (2*i+9)*outStride), _mm256_extracti128_si256(odd, 1));
+            }
+        }
+
+        FRAMEGEN_TARGET("avx2")
+        void toChannelsAVX2(const adc_t* tile, const unsigned Nframes, adc_t* matrix, const size_t stride) {
+            const unsigned full = Nframes/8*8;
+            for(unsigned ch=0; ch<num_ch_per_frame; ch+=16)
+                for(unsigned f=0; f<full; f+=8)
+                    block8x16(tile + f*num_ch_per_frame + ch, num_ch_per_frame, matrix + ch*stride + f, stride);
+            for(unsigned ch=0; ch<num_ch_per_frame; ch++)
+                for(unsigned f=full; f<Nframes; f++)
+                    matrix[ch*stride + f] = tile[f*num_ch_per_frame + ch];
+        }
+
+        FRAMEGEN_TARGET("avx2")
+        void toFramesAVX2(const adc_t* matrix, const size_t stride, const unsigned Nframes, adc_t* tile) {
+            const unsigned full = Nframes/16*16;
+            for(unsigned f=0; f<full; f+=16)
+                for(unsigned ch=0; ch<num_ch_per_frame; ch+=8)
+                    block8x16(matrix + ch*stride + f, stride, tile + f*num_ch_per_frame + ch, num_ch_per_frame);
+            for(unsigned f=full; f<Nframes; f++)
+                for(unsigned ch=0; ch<num_ch_per_frame; ch++)
+                    tile[f*num_ch_per_frame + ch] = matrix[ch*stride + f];
+        }
+#endif
+
+        //==========
+        // Dispatch
+        //==========
+        typedef void (*stream_rows_fn)(const adc_t* rows, adc_t* matrix, size_t stride);
+
+        struct TransposeKernels {
+            to_channels_fn toChannels;
+            to_frames_fn toFrames;
+            stream_rows_fn streamRows;  // Null where there are no streaming stores.
+            const char* name;
+        };
+
+        TransposeKernels selectKernels() {
+#ifdef FRAMEGEN_X86
+            if(cpu::supports_avx2()) {
+                TransposeKernels k = {toChannelsAVX2, toFramesAVX2, streamRowsSSE41, "avx2"};
+                return k;
+            }
+            if(cpu::supports_sse41()) {
+                TransposeKernels k = {toChannelsSSE41, toFramesSSE41, streamRowsSSE41, "sse4.1"};
+                return k;
+            }
+#endif
+            TransposeKernels k = {toChannelsScalar, toFramesScalar, nullptr, "scalar"};
+            return k;
+        }
+
+        const TransposeKernels& kernels() {
+            static const TransposeKernels k = selectKernels();
+            return k;
+        }
+    } // namespace
+
+    bool transpose(const Frame* frames, const size_t Nframes, adc_t* matrix, const size_t stride) {
+        if(stride < Nframes) {
+            std::cout << "Error (transpose()): a stride of " << stride << " does not fit " << Nframes << " frames." << std::endl;
+            return false;
+        }
+        const TransposeKernels& k = kernels();
+        // Matrices much bigger than the cache are written around it, as long as every row stays 16-byte aligned.
+        const bool stream = k.streamRows && (size_t)Nframes*num_ch_per_frame*sizeof(adc_t) >= stream_bytes
+            && !((uintptr_t)matrix % 16) && !(stride*sizeof(adc_t) % 16);
+        alignas(16) adc_t tile[tile_frames*num_ch_per_frame];
+        alignas(16) adc_t rows[num_ch_per_frame*tile_frames];
+        for(size_t first=0; first<Nframes; first+=tile_frames) {
+            const unsigned count = std::min<size_t>(tile_frames, Nframes-first);
+            for(unsigned f=0; f<count; f++)
+                unpack(frames[first+f], tile + f*num_ch_per_frame);
+            if(stream && count == tile_frames) {
+                k.toChannels(tile, count, rows, tile_frames);
+                k.streamRows(rows, matrix + first, stride);
+            } else {
+                k.toChannels(tile, count, matrix + first, stride);
+            }
+        }
+        return true;
+    }
+
+    bool untranspose(const adc_t* matrix, const size_t stride, Frame* frames, const size_t Nframes, const bool checksums) {
+        if(stride < Nframes) {
+            std::cout << "Error (untranspose()): a stride of " << stride << " does not fit " << Nframes << " frames." << std::endl;
+            return false;
+        }
+        const TransposeKernels& k = kernels();
+        adc_t tile[tile_frames*num_ch_per_frame];
+        for(size_t first=0; first<Nframes; first+=tile_frames) {
+            const unsigned count = std::min<size_t>(tile_frames, Nframes-first);
+            k.toFrames(matrix + first, stride, count, tile);
+            for(unsigned f=0; f<count; f++) {
+                pack(frames[first+f], tile + f*num_ch_per_frame);
+                if(checksums)
+                    frames[first+f].resetChecksums();
+            }
+        }
+        return true;
+    }
+
+    const char* transpose_kernel() { return kernels().name; }
+
+    //===============
+    // ChannelMatrix
+    //===============
+    ChannelMatrix::~ChannelMatrix() { free(_data); }
+
+    bool ChannelMatrix::resize(const size_t Nframes) {
+        const size_t perLine = alignment/sizeof(adc_t);
+        const size_t stride = std::max<size_t>(1, (Nframes+perLine-1)/perLine)*perLine;
+        const size_t samples = stride*num_ch_per_frame;
+        if(samples > _capacity) {
+            void* data = nullptr;
+            if(posix_memalign(&data, alignment, samples*sizeof(adc_t))) {
+                std::cout << "Error (ChannelMatrix::resize()): could not allocate room for " << Nframes << " frames." << std::endl;
+                return false;
+            }
+            free(_data);
+            _data = static_cast<adc_t*>(data);
+            _capacity = samples;
+        }
+        _frames = Nframes;
+        _stride = stride;
+        return true;
+    }
+
+    bool ChannelMatrix::load(const Frame* frames, const size_t Nframes) {
+        return resize(Nframes) && transpose(frames, Nframes, _data, _stride);
+    }
+
+    bool ChannelMatrix::store(Frame* frames, const bool checksums) const {
+        return untranspose(_data, _stride, frames, _frames, checksums);
+    }
+
+} // namespace framegen
@@ -0,0 +1,83 @@
+//==========================================================================
+// Name        : Transpose.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Conversion between frames and channel-major sample arrays.
+//============================================================================
+
+#ifndef FRAMEGEN_TRANSPOSE_HPP_
+#define FRAMEGEN_TRANSPOSE_HPP_
+
+#include <vector>
+
+#include "FrameGen.hpp"
+
+namespace framegen {
+
+// Frames hold one sample of every channel; these functions convert a batch of
+// frames to and from a num_ch_per_frame x Nframes matrix with one row per
+// channel, the time series of that channel: channel ch of frame i is at
+// matrix[ch*stride + i]. Channels are numbered as Frame::channel(ch) and the
+// samples are bit-exact with ColdataBlock::channel() and set_channel().
+//
+// Frames are unpacked a tile at a time into a buffer that stays in cache,
+// and the tile is transposed in 8x8 blocks of vector shuffles, so every row is
+// written whole cache lines at a time. Matrices much larger than the cache
+// are written with streaming stores when their rows are 16-byte aligned.
+//
+// Both return false if stride is smaller than Nframes.
+bool transpose(const Frame* frames, size_t Nframes, adc_t* matrix,
+               size_t stride);
+// Only the ADC samples of the frames are replaced; with checksums set the
+// COLDATA checksums and CRC are recomputed to match.
+bool untranspose(const adc_t* matrix, size_t stride, Frame* frames,
+                 size_t Nframes, bool checksums = true);
+
+// Name of the kernel selected for this CPU ("avx2", "sse4.1" or "scalar").
+const char* transpose_kernel();
+
+// ==================================================================
+// Channel-major matrix that owns its storage. Rows are padded to whole
+// cache lines and aligned to them; the buffer is only reallocated when it
+// has to grow.
+// ==================================================================
+class ChannelMatrix {
+ private:
+  adc_t* _data = nullptr;
+  size_t _frames = 0;
+  size_t _stride = 0;
+  size_t _capacity = 0;  // Samples allocated.
+
+ public:
+  static const size_t alignment = 64;
+
+  ChannelMatrix() {}
+  explicit ChannelMatrix(size_t Nframes) { resize(Nframes); }
+  ~ChannelMatrix();
+  ChannelMatrix(const ChannelMatrix&) = delete;
+  ChannelMatrix& operator=(const ChannelMatrix&) = delete;
+
+  // Room for Nframes samples per channel. The contents are not kept.
+  bool resize(size_t Nframes);
+
+  // Replace the contents by the samples of the frames.
+  bool load(const Frame* frames, size_t Nframes);
+  bool load(const std::vector<Frame>& frames) {
+    return load(frames.data(), frames.size());
+  }
+  // Write the samples back into frames() frames.
+  bool store(Frame* frames, bool checksums = true) const;
+
+  size_t frames() const { return _frames; }
+  size_t stride() const { return _stride; }
+  adc_t* data() { return _data; }
+  const adc_t* data() const { return _data; }
+  adc_t* channel(unsigned ch) { return _data + ch * _stride; }
+  const adc_t* channel(unsigned ch) const { return _data + ch * _stride; }
+  adc_t at(unsigned ch, size_t i) const { return _data[ch * _stride + i]; }
+};
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_TRANSPOSE_HPP_ */
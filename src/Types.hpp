@@ -0,0 +1,39 @@
+//==========================================================================
+// Name        : Types.hpp
+// Author      : Milo Vermeulen, FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2017, 2026 Milo Vermeulen and FrameGen contributors
+// Description : Basic types and frame dimensions shared by all of FrameGen.
+//============================================================================
+
+#ifndef FRAMEGEN_TYPES_HPP_
+#define FRAMEGEN_TYPES_HPP_
+
+#include <cstdint>
+
+#define CRC32_POLYNOMIAL 3988292384
+
+namespace framegen {
+typedef uint32_t word_t;
+typedef uint16_t adc_t;
+
+// Constants for general use.
+static const unsigned num_frame_hdr_words = 4;
+static const unsigned num_COLDATA_hdr_words = 4;
+static const unsigned num_frame_words = 117;
+static const unsigned num_frame_bytes = num_frame_words * 4;
+static const unsigned num_COLDATA_words = 28;
+
+static const unsigned num_ch_per_frame = 256;
+static const unsigned num_ch_per_block = 64;
+static const unsigned num_stream_per_block = 8;
+static const unsigned num_ch_per_stream = 8;
+
+// Timestamp increment between consecutive frames, in ns. Frames are sent at
+// the nominal WIB rate of 2 MHz.
+static const uint64_t frame_timestamp_step = 500;
+static const double nominal_frame_rate = 2e6;
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_TYPES_HPP_ */
@@ -0,0 +1,136 @@
+//============================================================================
+// Name        : Verify.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Single-pass checksum and CRC verification of frames.
+//============================================================================
+
+#include "src/Verify.hpp"
+#include "src/CRC32.hpp"
+#include "src/Cpu.hpp"
+#include "src/Format.hpp"
+#include "src/FrameGen.hpp"
+
+namespace framegen {
+
+    namespace {
+        // XOR (A) and sum (B) of the 16-bit halves of the checksummed words, for all blocks. Written as masked
+        // straight-line loops so the compiler vectorises them over the ADC words of a block.
+        template<class Format>
+        FRAMEGEN_ALWAYS_INLINE void checksumBody(const word_t* frame, uint16_t a[], uint16_t b[]) {
+            const word_t* mask = ChecksumTable<Format>::a_mask;
+            for(unsigned blk=0; blk<Format::num_blocks; blk++) {
+                const word_t* adcs = frame + Format::adc_word(blk);
+                uint32_t x = 0, lo = 0, hi = 0;
+                for(unsigned i=0; i<Format::num_adc_words; i++) {
+                    const uint32_t inA = adcs[i] & mask[i];
+                    const uint32_t inB = adcs[i] & ~mask[i];
+                    x ^= inA;
+                    lo += inB & 0xFFFF;
+                    hi += inB >> 16;
+                }
+                a[blk] = (x ^ (x>>16)) & 0xFFFF;
+                b[blk] = -(lo + hi);
+            }
+        }
+
+        template<class Format>
+        FRAMEGEN_ALWAYS_INLINE uint32_t statusBody(const word_t* frame) {
+            uint16_t a[Format::num_blocks], b[Format::num_blocks];
+            checksumBody<Format>(frame, a, b);
+            uint32_t status = 0;
+            for(unsigned blk=0; blk<Format::num_blocks; blk++) {
+                status |= (Format::checksum_a(frame, blk) != a[blk]) * (status_checksum_a << blk);
+                status |= (Format::checksum_b(frame, blk) != b[blk]) * (status_checksum_b << blk);
+                status |= (get_field(frame, Format::block_field(blk, Format::s1_error())) != 0) * (status_s1_error << blk);
+                status |= (get_field(frame, Format::block_field(blk, Format::s2_error())) != 0) * (status_s2_error << blk);
+            }
+            status |= (get_field(frame, Format::wib_errors()) != 0) * status_wib_error;
+            // The frame is still in L1 from the checksum loop, so the CRC does not touch memory again.
+            status |= (zcrc32_frame(frame) != frame[Format::crc_word]) * status_crc;
+            return status;
+        }
+
+        // Verifies frames with one layout until the version changes; returns the number of frames done.
+        template<class Format>
+        FRAMEGEN_ALWAYS_INLINE size_t verifyRun(const word_t* frames, size_t Nframes, uint32_t* status,
+                                                const uint8_t version, const uint32_t flags) {
+            size_t i = 0;
+            do {
+                const word_t* frame = frames + i*num_frame_words;
+#if defined(__GNUC__) || defined(__clang__)
+                if(i+4 < Nframes)
+                    __builtin_prefetch(frame + 4*num_frame_words);
+#endif
+                status[i] = statusBody<Format>(frame) | flags;
+            } while(++i < Nframes && frame_version(frames + i*num_frame_words) == version);
+            return i;
+        }
+
+        struct RunVisitor {
+            const word_t* frames;
+            size_t Nframes;
+            uint32_t* status;
+            uint8_t version;
+            size_t done;
+            template<class Format>
+            FRAMEGEN_ALWAYS_INLINE void operator()(Format) {
+                done = verifyRun<Format>(frames, Nframes, status, version, 0);
+            }
+        };
+
+        // Frames are checked against the layout their version selects, and unknown versions against the default
+        // one. Files hold long runs of one version, so the layout is only looked up when the version changes.
+        FRAMEGEN_ALWAYS_INLINE void verifyBody(const word_t* frames, size_t Nframes, uint32_t* status) {
+            size_t first = 0;
+            while(first < Nframes) {
+                RunVisitor run = {frames + first*num_frame_words, Nframes-first, status+first, 0, 0};
+                run.version = frame_version(run.frames);
+                if(!dispatch_format(run.version, run))
+                    run.done = verifyRun<DefaultFormat>(run.frames, run.Nframes, run.status, run.version,
+                                                        status_unknown_version);
+                first += run.done;
+            }
+        }
+
+        void verifyScalar(const word_t* frames, size_t Nframes, uint32_t* status) {
+            verifyBody(frames, Nframes, status);
+        }
+
+#ifdef FRAMEGEN_X86
+        FRAMEGEN_TARGET("avx2")
+        void verifyAVX2(const word_t* frames, size_t Nframes, uint32_t* status) {
+            verifyBody(frames, Nframes, status);
+        }
+#endif
+
+        typedef void (*verify_fn)(const word_t*, size_t, uint32_t*);
+
+        verify_fn selectKernel() {
+#ifdef FRAMEGEN_X86
+            if(cpu::supports_avx2())
+                return verifyAVX2;
+#endif
+            return verifyScalar;
+        }
+
+        verify_fn kernel() {
+            static const verify_fn k = selectKernel();
+            return k;
+        }
+    } // namespace
+
+    void calculate_checksums(const word_t* frame, uint16_t checksum_a[4], uint16_t checksum_b[4]) {
+        checksumBody<WIB1Format>(frame, checksum_a, checksum_b);
+    }
+
+    uint32_t verify_frame(const word_t* frame) {
+        uint32_t status;
+        kernel()(frame, 1, &status);
+        return status;
+    }
+
+    void verify_frames(const word_t* frames, size_t Nframes, uint32_t* status) { kernel()(frames, Nframes, status); }
+
+} // namespace framegen
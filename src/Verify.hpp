@@ -0,0 +1,47 @@
+//==========================================================================
+// Name        : Verify.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Single-pass checksum and CRC verification of frames.
+//============================================================================
+
+#ifndef FRAMEGEN_VERIFY_HPP_
+#define FRAMEGEN_VERIFY_HPP_
+
+#include <cstddef>
+
+#include "Types.hpp"
+
+namespace framegen {
+
+// Per-frame status bits produced by verify_frame(). A frame is fine when no
+// bit in status_failure_mask is set; the error-bit flags only mirror the
+// error bits stored in the frame.
+static const uint32_t status_checksum_a = 1 << 0;  // Bits 0-3: block 0-3.
+static const uint32_t status_checksum_b = 1 << 4;  // Bits 4-7: block 0-3.
+static const uint32_t status_crc = 1 << 8;
+static const uint32_t status_wib_error = 1 << 9;
+static const uint32_t status_s1_error = 1 << 10;  // Bits 10-13: block 0-3.
+static const uint32_t status_s2_error = 1 << 14;  // Bits 14-17: block 0-3.
+// The version field names no known layout (see Format.hpp); the frame was
+// checked as a WIB 1.0 frame. Neither a failure nor an error bit.
+static const uint32_t status_unknown_version = 1 << 18;
+
+static const uint32_t status_failure_mask = 0x1FF;
+static const uint32_t status_error_bit_mask = 0x3FE00;
+
+// Both checksums of all four COLDATA blocks in one pass over the ADC words.
+void calculate_checksums(const word_t* frame, uint16_t checksum_a[4],
+                         uint16_t checksum_b[4]);
+
+// Verify the checksums and zlib CRC of a frame against the values stored in
+// it and collect its error bits. The fields are read with the layout selected
+// by the version of the frame.
+uint32_t verify_frame(const word_t* frame);
+// Same for Nframes contiguous frames; status receives one word per frame.
+void verify_frames(const word_t* frames, size_t Nframes, uint32_t* status);
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_VERIFY_HPP_ */
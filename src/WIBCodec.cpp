@@ -0,0 +1,247 @@
+//============================================================================
+// Name        : WIBCodec.cpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Lossless frame-aware codec with temporal ADC prediction.
+//============================================================================
+
+#include "src/WIBCodec.hpp"
+#include "src/CRC32.hpp"
+#include "src/FrameGen.hpp"
+#include "src/Pack.hpp"
+#include "src/Rans.hpp"
+#include "src/Verify.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace framegen {
+
+    namespace {
+        // Words that are not ADC data: the frame header, the four COLDATA headers and the CRC.
+        const unsigned num_side_words = num_frame_hdr_words + 4*num_COLDATA_hdr_words + 1;
+        const unsigned num_side_bytes = num_side_words*4;
+        const unsigned escape = 255;
+
+        unsigned sideWord(const unsigned i) {
+            if(i < num_frame_hdr_words)
+                return i;
+            if(i == num_side_words-1)
+                return num_frame_words-1;
+            const unsigned j = i - num_frame_hdr_words;
+            return num_frame_hdr_words + (j/num_COLDATA_hdr_words)*num_COLDATA_words + j%num_COLDATA_hdr_words;
+        }
+
+        inline uint64_t timestampWords(const word_t* frame) { return (uint64_t)frame[2] | (uint64_t)frame[3]<<32; }
+
+        // Predicted side words of a frame whose ADC words are known. The CRC is left out; it can only be predicted
+        // once the other side words are restored.
+        class SidePredictor {
+        private:
+            word_t _prev[num_frame_words];
+            uint64_t _prevTimestamp = 0, _delta = 0;
+            bool _first = true;
+
+        public:
+            SidePredictor() { memset(_prev, 0, sizeof(_prev)); }
+
+            void predict(const word_t* frame, word_t pred[num_side_words]) const {
+                for(unsigned i=0; i<num_side_words; i++)
+                    pred[i] = _prev[sideWord(i)];
+                const uint64_t timestamp = _prevTimestamp + _delta;
+                pred[2] = timestamp;
+                pred[3] = timestamp >> 32;
+
+                uint16_t a[4], b[4];
+                calculate_checksums(frame, a, b);
+                for(unsigned blk=0; blk<4; blk++) {
+                    ColdataHeader head;
+                    memcpy(&head, &pred[num_frame_hdr_words + blk*num_COLDATA_hdr_words], sizeof(head));
+                    head.set_checksum_a(a[blk]);
+                    head.set_checksum_b(b[blk]);
+                    memcpy(&pred[num_frame_hdr_words + blk*num_COLDATA_hdr_words], &head, sizeof(head));
+                }
+            }
+
+            void update(const word_t* frame) {
+                const uint64_t timestamp = timestampWords(frame);
+                if(!_first)
+                    _delta = timestamp - _prevTimestamp;
+                _prevTimestamp = timestamp;
+                _first = false;
+                memcpy(_prev, frame, sizeof(_prev));
+            }
+        };
+
+        inline unsigned zigzag(int r) { return r >= 0 ? 2*r : -2*r-1; }
+        inline int unzigzag(unsigned z) { return z&1 ? -(int)((z+1)/2) : (int)(z/2); }
+        // Residual of a 12-bit sample, wrapped to -2048..2047.
+        inline int residual(unsigned value, unsigned pred) { return ((int)((value - pred) << 20)) >> 20; }
+
+        // Rows of the frames that the predictor uses; frames before the first repeat the first.
+        inline void history(const adc_t* values, const size_t f, const adc_t* rows[4]) {
+            for(size_t k=0; k<4; k++)
+                rows[k] = values + (f > k+1 ? f-k-1 : 0)*num_ch_per_frame;
+        }
+
+        inline unsigned predictSample(const uint8_t predictor, const adc_t* rows[4], const unsigned ch) {
+            if(predictor == wib_predict_previous)
+                return rows[0][ch];
+            return (rows[0][ch] + rows[1][ch] + rows[2][ch] + rows[3][ch] + 2) >> 2;
+        }
+
+        uint64_t predictionCost(const adc_t* values, const size_t Nframes, const uint8_t predictor) {
+            uint64_t cost = 0;
+            for(size_t f=1; f<Nframes; f++) {
+                const adc_t* rows[4];
+                history(values, f, rows);
+                const adc_t* row = values + f*num_ch_per_frame;
+                for(unsigned ch=0; ch<num_ch_per_frame; ch++)
+                    cost += abs(residual(row[ch], predictSample(predictor, rows, ch)));
+            }
+            return cost;
+        }
+
+        inline void put32(std::vector<uint8_t>& out, uint32_t v) {
+            for(int i=0; i<4; i++)
+                out.push_back((uint8_t)(v >> 8*i));
+        }
+        inline bool get32(const uint8_t*& in, const uint8_t* end, uint32_t& v) {
+            if(end - in < 4)
+                return false;
+            v = (uint32_t)in[0] | (uint32_t)in[1]<<8 | (uint32_t)in[2]<<16 | (uint32_t)in[3]<<24;
+            in += 4;
+            return true;
+        }
+    } // namespace
+
+    // Layout: predictor (1), frame count (4), ADC block, side block, escape count (4), escapes (2 each), raw tail.
+    // When that is no smaller than the input: wib_stored (1), the input.
+    void wib_compress(const uint8_t* data, const size_t bytes, std::vector<uint8_t>& out, const int level) {
+        const size_t Nframes = bytes / num_frame_bytes;
+        std::vector<adc_t> values(Nframes*num_ch_per_frame);
+        std::vector<uint8_t> sides(Nframes*num_side_bytes);
+        SidePredictor side;
+        Frame frame;
+
+        for(size_t f=0; f<Nframes; f++) {
+            memcpy(frame.data(), data + f*num_frame_bytes, num_frame_bytes);
+            unpack(frame, &values[f*num_ch_per_frame]);
+
+            word_t pred[num_side_words];
+            side.predict(frame.data(), pred);
+            pred[num_side_words-1] = zcrc32_frame(frame.data());
+            for(unsigned i=0; i<num_side_words; i++) {
+                const word_t x = frame.data()[sideWord(i)] ^ pred[i];
+                memcpy(&sides[f*num_side_bytes + 4*i], &x, 4);
+            }
+            side.update(frame.data());
+        }
+
+        uint8_t predictor = wib_predict_previous;
+        if(level > 0 && predictionCost(values.data(), Nframes, wib_predict_mean4) < predictionCost(values.data(), Nframes, wib_predict_previous))
+            predictor = wib_predict_mean4;
+
+        std::vector<uint8_t> symbols(values.size());
+        std::vector<uint16_t> escapes;
+        for(size_t f=0; f<Nframes; f++) {
+            const adc_t* rows[4];
+            history(values.data(), f, rows);
+            const adc_t* row = &values[f*num_ch_per_frame];
+            uint8_t* sym = &symbols[f*num_ch_per_frame];
+            for(unsigned ch=0; ch<num_ch_per_frame; ch++) {
+                const unsigned z = zigzag(residual(row[ch], f ? predictSample(predictor, rows, ch) : 0));
+                sym[ch] = z < escape ? z : escape;
+                if(z >= escape)
+                    escapes.push_back(z);
+            }
+        }
+
+        const size_t start = out.size();
+        out.push_back(predictor);
+        put32(out, Nframes);
+        rans_encode(symbols.data(), symbols.size(), out);
+        rans_encode(sides.data(), sides.size(), out);
+        put32(out, escapes.size());
+        for(size_t i=0; i<escapes.size(); i++) {
+            out.push_back((uint8_t)escapes[i]);
+            out.push_back((uint8_t)(escapes[i] >> 8));
+        }
+        out.insert(out.end(), data + Nframes*num_frame_bytes, data + bytes);
+
+        if(out.size() - start > bytes) {
+            out.resize(start);
+            out.push_back(wib_stored);
+            out.insert(out.end(), data, data + bytes);
+        }
+    }
+
+    bool wib_decompress(const uint8_t* data, const size_t size, uint8_t* out, const size_t rawBytes) {
+        const uint8_t* in = data;
+        const uint8_t* const end = data + size;
+        const size_t Nframes = rawBytes / num_frame_bytes;
+        const size_t tail = rawBytes % num_frame_bytes;
+
+        uint32_t storedFrames;
+        if(in >= end)
+            return false;
+        const uint8_t predictor = *in++;
+        if(predictor == wib_stored) {
+            if((size_t)(end - in) != rawBytes)
+                return false;
+            memcpy(out, in, rawBytes);
+            return true;
+        }
+        if(predictor > wib_predict_mean4 || !get32(in, end, storedFrames) || storedFrames != Nframes)
+            return false;
+
+        std::vector<uint8_t> symbols(Nframes*num_ch_per_frame), sides(Nframes*num_side_bytes);
+        uint32_t Nescapes;
+        if(!rans_decode(in, end, symbols.data(), symbols.size()) || !rans_decode(in, end, sides.data(), sides.size())
+           || !get32(in, end, Nescapes) || (size_t)(end - in) != 2*(size_t)Nescapes + tail)
+            return false;
+        const uint8_t* escapes = in;
+        const uint8_t* const escapesEnd = in + 2*(size_t)Nescapes;
+
+        std::vector<adc_t> values(Nframes*num_ch_per_frame);
+        SidePredictor side;
+        Frame frame;
+        for(size_t f=0; f<Nframes; f++) {
+            const adc_t* rows[4];
+            history(values.data(), f, rows);
+            adc_t* row = &values[f*num_ch_per_frame];
+            const uint8_t* sym = &symbols[f*num_ch_per_frame];
+            for(unsigned ch=0; ch<num_ch_per_frame; ch++) {
+                unsigned z = sym[ch];
+                if(z == escape) {
+                    if(escapes >= escapesEnd)
+                        return false;
+                    z = escapes[0] | escapes[1]<<8;
+                    escapes += 2;
+                }
+                const unsigned pred = f ? predictSample(predictor, rows, ch) : 0;
+                row[ch] = (pred + unzigzag(z)) & 0xFFF;
+            }
+            pack(frame, row);
+
+            word_t pred[num_side_words];
+            side.predict(frame.data(), pred);
+            for(unsigned i=0; i<num_side_words-1; i++) {
+                word_t x;
+                memcpy(&x, &sides[f*num_side_bytes + 4*i], 4);
+                frame.data()[sideWord(i)] = x ^ pred[i];
+            }
+            word_t crc;
+            memcpy(&crc, &sides[f*num_side_bytes + 4*(num_side_words-1)], 4);
+            frame.data()[num_frame_words-1] = crc ^ zcrc32_frame(frame.data());
+            side.update(frame.data());
+            memcpy(out + f*num_frame_bytes, frame.data(), num_frame_bytes);
+        }
+        if(escapes != escapesEnd)
+            return false;
+        memcpy(out + Nframes*num_frame_bytes, escapesEnd, tail);
+        return true;
+    }
+
+} // namespace framegen
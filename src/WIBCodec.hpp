@@ -0,0 +1,50 @@
+//==========================================================================
+// Name        : WIBCodec.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Lossless frame-aware codec with temporal ADC prediction.
+//============================================================================
+
+#ifndef FRAMEGEN_WIBCODEC_HPP_
+#define FRAMEGEN_WIBCODEC_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "Types.hpp"
+
+namespace framegen {
+
+// ==================================================================
+// The codec unpacks the 256 channels of every frame and predicts each
+// sample from the same channel in earlier frames of the chunk, either the
+// previous frame or the mean of the last four. Residuals are zigzag-coded
+// and rANS-coded as bytes, with an escape for the rare large ones. The
+// other words are predicted as well (the timestamp linearly, checksums and
+// CRC from the reconstructed data, the rest from the previous frame) and
+// only the XOR with the prediction is coded, so damaged checksums and error
+// bits survive exactly. Input that is not a whole number of frames keeps its
+// tail as raw bytes, and input that does not get smaller, such as noise, is
+// stored as it is behind a single mode byte.
+// ==================================================================
+
+enum WIBPredictor : uint8_t {
+  wib_predict_previous = 0,  // Same channel, previous frame.
+  wib_predict_mean4 = 1,     // Mean of the same channel in the last 4 frames.
+  wib_stored = 2,            // Not coded: the raw bytes follow.
+};
+
+// Append the coded form of bytes bytes of frames to out. Level 0 always uses
+// the previous-frame predictor; level 1 picks the predictor with the smaller
+// residuals for each call. There are no higher levels.
+void wib_compress(const uint8_t* data, size_t bytes, std::vector<uint8_t>& out,
+                  int level = 1);
+// Decode exactly rawBytes bytes from the size bytes at data. Returns false if
+// the data is corrupt.
+bool wib_decompress(const uint8_t* data, size_t size, uint8_t* out,
+                    size_t rawBytes);
+
+}  // namespace framegen
+
+#endif /* FRAMEGEN_WIBCODEC_HPP_ */
@@ -0,0 +1,281 @@
+// Compression benchmark: generates frames over a grid of noise settings and runs every available compressor and level
+// on them, reporting ratio, throughput and peak memory as CSV or JSON. Every run happens in a child process of its own,
+// so its peak memory is its own.
+//
+// Usage: framegen-compbench [options]
+//   --pedestal a,b,...     Noise pedestals (default 250).
+//   --amplitude a,b,...    Noise amplitudes (default 10).
+//   --errprob a,b,...      Error bit probabilities (default 0.00001).
+//   --frames a,b,...       Frame counts (default 10000).
+//   --codecs all|a,b,...   Compressors by name (default all).
+//   --levels all|default   Every level of each compressor, or only its default (default all).
+//   --chunk n              Frames per compressed chunk (default 4096).
+//   --threads n            Generator threads (default 1, 0 = all cores).
+//   --seed n               Noise seed (default 1).
+//   --format csv|json      Output format (default csv).
+//   --output file          Write the results to a file instead of std::cout.
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "src/Compress.hpp"
+#include "src/Compressor.hpp"
+#include "src/FrameGen.hpp"
+
+namespace {
+    struct Result {
+        double pedestal, amplitude, errProb;
+        unsigned long frames;
+        std::string codec;
+        int level;
+        uint64_t rawBytes, compressedBytes;
+        double compressMBps, decompressMBps;
+        long peakKB; // Growth of the peak resident set size over the run, -1 if unknown.
+        bool verified;
+    };
+
+    // What a child process sends back of its run.
+    struct Measured {
+        uint64_t compressedBytes;
+        double compressMBps, decompressMBps;
+        long peakKB;
+        bool verified;
+    };
+
+    std::vector<std::string> split(const std::string& list) {
+        std::vector<std::string> items;
+        std::stringstream ss(list);
+        std::string item;
+        while(std::getline(ss, item, ','))
+            if(!item.empty())
+                items.push_back(item);
+        return items;
+    }
+
+    std::vector<double> numbers(const std::string& list) {
+        std::vector<double> values;
+        std::vector<std::string> items = split(list);
+        for(size_t i=0; i<items.size(); i++)
+            values.push_back(atof(items[i].c_str()));
+        return values;
+    }
+
+    // Peak resident set size of the process so far, in kB. It never decreases; a child process starts at the size
+    // it had when forked.
+    long peakKB() {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    // Compress the frames chunk by chunk as the container would, then decompress and compare.
+    Result run(framegen::Compressor& compressor, const std::vector<framegen::Frame>& frames, unsigned chunkFrames) {
+        Result r = Result();
+        r.codec = compressor.name();
+        r.level = compressor.level();
+        r.frames = frames.size();
+        r.rawBytes = frames.size()*framegen::num_frame_bytes;
+
+        const uint8_t* raw = reinterpret_cast<const uint8_t*>(frames.data());
+        const size_t chunkBytes = (size_t)chunkFrames*framegen::num_frame_bytes;
+        std::vector<std::vector<uint8_t> > chunks;
+        bool ok = true;
+        for(size_t offset=0; offset<r.rawBytes; offset+=chunkBytes) {
+            chunks.push_back(std::vector<uint8_t>());
+            ok = compressor.compress(raw+offset, std::min<size_t>(chunkBytes, r.rawBytes-offset), chunks.back()) && ok;
+        }
+
+        std::vector<uint8_t> out(chunkBytes);
+        for(size_t c=0; c<chunks.size(); c++) {
+            const size_t offset = c*chunkBytes;
+            const size_t size = std::min<size_t>(chunkBytes, r.rawBytes-offset);
+            ok = compressor.decompress(chunks[c].data(), chunks[c].size(), out.data(), size)
+                && !memcmp(out.data(), raw+offset, size) && ok;
+        }
+
+        // Count everything compressFile() writes around the payloads: the header, the sizes and CRC of every
+        // chunk, the end marker and the seek index with its trailer, as set by the default header flags.
+        const framegen::ContainerHeader header;
+        const size_t chunkHeadBytes = 8 + (header.flags & framegen::ContainerHeader::flag_chunk_crc? 4: 0);
+        r.compressedBytes = framegen::ContainerHeader::size + chunkHeadBytes*chunks.size() + 8;
+        if(header.flags & framegen::ContainerHeader::flag_index)
+            r.compressedBytes += framegen::ChunkIndexEntry::size*chunks.size() + framegen::ChunkIndexEntry::trailer_size;
+        for(size_t c=0; c<chunks.size(); c++)
+            r.compressedBytes += chunks[c].size();
+        r.compressMBps = compressor.compressStats().MBps();
+        r.decompressMBps = compressor.decompressStats().MBps();
+        r.peakKB = -1;
+        r.verified = ok;
+        return r;
+    }
+
+    // run() in a child process, so that the peak resident set size covers this compressor only: the growth of the
+    // child's peak is the memory the run needed on top of the frames. Runs here, without a peak, if there is no child.
+    Result runIsolated(framegen::Compressor& compressor, const std::vector<framegen::Frame>& frames,
+                       unsigned chunkFrames) {
+        int fds[2];
+        if(pipe(fds) == 0) {
+            const pid_t pid = fork();
+            if(pid == 0) {
+                close(fds[0]);
+                const long before = peakKB();
+                const Result r = run(compressor, frames, chunkFrames);
+                const Measured m = {r.compressedBytes, r.compressMBps, r.decompressMBps, peakKB() - before, r.verified};
+                _exit(write(fds[1], &m, sizeof(m)) == (ssize_t)sizeof(m) ? 0 : 1);
+            }
+            close(fds[1]);
+            Measured m;
+            const bool received = pid > 0 && read(fds[0], &m, sizeof(m)) == (ssize_t)sizeof(m);
+            close(fds[0]);
+            if(pid > 0) {
+                int status;
+                waitpid(pid, &status, 0);
+            }
+            if(received) {
+                Result r = Result();
+                r.codec = compressor.name();
+                r.level = compressor.level();
+                r.frames = frames.size();
+                r.rawBytes = frames.size()*framegen::num_frame_bytes;
+                r.compressedBytes = m.compressedBytes;
+                r.compressMBps = m.compressMBps;
+                r.decompressMBps = m.decompressMBps;
+                r.peakKB = m.peakKB;
+                r.verified = m.verified;
+                return r;
+            }
+        }
+        std::cerr << "Warning: could not run " << compressor.name() << " in a child process; no peak memory." << std::endl;
+        return run(compressor, frames, chunkFrames);
+    }
+
+    void writeCSV(std::ostream& out, const std::vector<Result>& results) {
+        out << "pedestal,amplitude,error_probability,frames,codec,level,raw_bytes,compressed_bytes,ratio,"
+            << "compress_MBps,decompress_MBps,peak_rss_growth_kB,verified\n";
+        for(size_t i=0; i<results.size(); i++) {
+            const Result& r = results[i];
+            out << r.pedestal << ',' << r.amplitude << ',' << r.errProb << ',' << r.frames << ',' << r.codec << ','
+                << r.level << ',' << r.rawBytes << ',' << r.compressedBytes << ','
+                << (double)r.rawBytes/r.compressedBytes << ',' << r.compressMBps << ',' << r.decompressMBps << ','
+                << r.peakKB << ',' << (r.verified? "true": "false") << '\n';
+        }
+    }
+
+    void writeJSON(std::ostream& out, const std::vector<Result>& results) {
+        out << "[";
+        for(size_t i=0; i<results.size(); i++) {
+            const Result& r = results[i];
+            out << (i? ",\n ": "\n ") << "{\"pedestal\": " << r.pedestal << ", \"amplitude\": " << r.amplitude
+                << ", \"error_probability\": " << r.errProb << ", \"frames\": " << r.frames
+                << ", \"codec\": \"" << r.codec << "\", \"level\": " << r.level
+                << ", \"raw_bytes\": " << r.rawBytes << ", \"compressed_bytes\": " << r.compressedBytes
+                << ", \"ratio\": " << (double)r.rawBytes/r.compressedBytes
+                << ", \"compress_MBps\": " << r.compressMBps << ", \"decompress_MBps\": " << r.decompressMBps
+                << ", \"peak_rss_growth_kB\": " << r.peakKB << ", \"verified\": " << (r.verified? "true": "false") << "}";
+        }
+        out << "\n]\n";
+    }
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<double> pedestals(1, 250), amplitudes(1, 10), errProbs(1, 0.00001), frameCounts(1, 10000);
+    std::string codecs = "all", levels = "all", format = "csv", output;
+    unsigned chunkFrames = 4096, threads = 1;
+    uint64_t seed = 1;
+
+    for(int i=1; i<argc; i++) {
+        const std::string arg = argv[i];
+        if(i+1 >= argc) {
+            std::cout << "Error: option " << arg << " needs a value." << std::endl;
+            return 1;
+        }
+        const std::string value = argv[++i];
+        if(arg == "--pedestal") pedestals = numbers(value);
+        else if(arg == "--amplitude") amplitudes = numbers(value);
+        else if(arg == "--errprob") errProbs = numbers(value);
+        else if(arg == "--frames") frameCounts = numbers(value);
+        else if(arg == "--codecs") codecs = value;
+        else if(arg == "--levels") levels = value;
+        else if(arg == "--chunk") chunkFrames = std::max(1, atoi(value.c_str()));
+        else if(arg == "--threads") threads = atoi(value.c_str());
+        else if(arg == "--seed") seed = strtoull(value.c_str(), nullptr, 10);
+        else if(arg == "--format") format = value;
+        else if(arg == "--output") output = value;
+        else {
+            std::cout << "Error: unknown option " << arg << "." << std::endl;
+            return 1;
+        }
+    }
+
+    // Compressors to run.
+    std::vector<framegen::CompressorInfo> selected;
+    std::vector<framegen::CompressorInfo> available = framegen::compressors();
+    std::vector<std::string> names = split(codecs);
+    for(size_t i=0; i<available.size(); i++)
+        if(codecs == "all" || std::find(names.begin(), names.end(), available[i].name) != names.end())
+            selected.push_back(available[i]);
+    if(selected.empty()) {
+        std::cout << "Error: none of the requested compressors are available." << std::endl;
+        return 1;
+    }
+
+    std::vector<Result> results;
+    std::vector<framegen::Frame> frames;
+    for(size_t p=0; p<pedestals.size(); p++)
+    for(size_t a=0; a<amplitudes.size(); a++)
+    for(size_t e=0; e<errProbs.size(); e++)
+    for(size_t n=0; n<frameCounts.size(); n++) {
+        framegen::FrameGen generator;
+        generator.setThreads(threads);
+        generator.setPedestal(pedestals[p]);
+        generator.setAmplitude(amplitudes[a]);
+        generator.setErrorProbability(errProbs[e]);
+        generator.noise().seed(seed);
+        generator.generateBuffer(frames, (unsigned long)frameCounts[n]);
+
+        for(size_t c=0; c<selected.size(); c++) {
+            const framegen::CompressorInfo& info = selected[c];
+            const int first = levels == "all"? info.minLevel: info.defaultLevel;
+            const int last = levels == "all"? info.maxLevel: info.defaultLevel;
+            for(int level=first; level<=last; level++) {
+                std::unique_ptr<framegen::Compressor> compressor = info.factory(level);
+                Result r = runIsolated(*compressor, frames, chunkFrames);
+                r.pedestal = pedestals[p];
+                r.amplitude = amplitudes[a];
+                r.errProb = errProbs[e];
+                results.push_back(r);
+                std::cerr << r.codec << " level " << r.level << ": ratio " << (double)r.rawBytes/r.compressedBytes
+                    << ", " << r.compressMBps << " MB/s in, " << r.decompressMBps << " MB/s out" << std::endl;
+            }
+        }
+    }
+
+    std::ofstream ofile;
+    if(!output.empty()) {
+        ofile.open(output);
+        if(!ofile) {
+            std::cout << "Error: file " << output << " could not be opened." << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = output.empty()? std::cout: ofile;
+    if(format == "json")
+        writeJSON(out, results);
+    else
+        writeCSV(out, results);
+
+    for(size_t i=0; i<results.size(); i++)
+        if(!results[i].verified)
+            return 2;
+    return 0;
+}
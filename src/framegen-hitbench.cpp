@@ -0,0 +1,220 @@
+// Hit finder benchmark: generates frames with signal on top of the noise and runs the hit finder over them, reporting
+// the throughput per core of unpacking, of hit finding alone and of both, and the number of links of nominal rate a
+// core keeps up with, as CSV or JSON.
+//
+// Usage: framegen-hitbench [options]
+//   --frames n             Frames per run (default 100000).
+//   --pedestal n           Noise pedestal (default 250).
+//   --amplitude n          Noise amplitude (default 10).
+//   --hit-rate r           Isolated hits per frame (default 0.5).
+//   --track-rate r         Tracks per frame (default 0.01).
+//   --shower-rate r        Showers per frame (default 0.001).
+//   --threshold n          Hit threshold above pedestal (default 30).
+//   --pedestal-method m    median or mean (default median).
+//   --threads a,b,...      Cores to run on, one hit finder per core on the same frames (default 1).
+//   --repeat n             Runs per thread count; the fastest counts (default 3).
+//   --seed n               Noise seed (default 1).
+//   --format csv|json      Output format (default csv).
+//   --output file          Write the results to a file instead of std::cout.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "src/FrameGen.hpp"
+#include "src/HitFinder.hpp"
+#include "src/Pack.hpp"
+
+namespace {
+    struct Result {
+        unsigned threads;
+        unsigned long frames;
+        double unpackSeconds, findSeconds, totalSeconds;  // Per thread, slowest thread.
+        uint64_t primitives;
+    };
+
+    std::vector<double> numbers(const std::string& list) {
+        std::vector<double> values;
+        std::stringstream ss(list);
+        std::string item;
+        while(std::getline(ss, item, ','))
+            if(!item.empty())
+                values.push_back(atof(item.c_str()));
+        return values;
+    }
+
+    double seconds(const std::chrono::steady_clock::time_point& start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // One core's work: unpack every frame, find hits in the unpacked channels, then both in one pass as a readout
+    // would run them.
+    void runThread(const std::vector<framegen::Frame>& frames, const framegen::HitFinderOptions& options,
+                   Result& r) {
+        const size_t N = frames.size();
+        std::vector<framegen::adc_t> adcs(N*framegen::num_ch_per_frame);
+        std::vector<framegen::TriggerPrimitive> primitives;
+        primitives.reserve(N);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for(size_t i=0; i<N; i++)
+            framegen::unpack(frames[i], &adcs[i*framegen::num_ch_per_frame]);
+        r.unpackSeconds = seconds(start);
+
+        framegen::HitFinder finder(options);
+        start = std::chrono::steady_clock::now();
+        for(size_t i=0; i<N; i++)
+            finder.process(&adcs[i*framegen::num_ch_per_frame], frames[i].timestamp(), primitives);
+        finder.flush(primitives);
+        r.findSeconds = seconds(start);
+
+        primitives.clear();
+        finder.reset();
+        start = std::chrono::steady_clock::now();
+        finder.process(frames.data(), N, primitives);
+        finder.flush(primitives);
+        r.totalSeconds = seconds(start);
+        r.primitives = primitives.size();
+    }
+
+    Result run(const std::vector<framegen::Frame>& frames, const framegen::HitFinderOptions& options,
+               unsigned threads) {
+        std::vector<Result> results(threads);
+        std::vector<std::thread> workers;
+        for(unsigned t=0; t<threads; t++)
+            workers.push_back(std::thread(runThread, std::cref(frames), std::cref(options), std::ref(results[t])));
+        for(unsigned t=0; t<threads; t++)
+            workers[t].join();
+        Result r = results[0];
+        for(unsigned t=1; t<threads; t++) {
+            r.unpackSeconds = std::max(r.unpackSeconds, results[t].unpackSeconds);
+            r.findSeconds = std::max(r.findSeconds, results[t].findSeconds);
+            r.totalSeconds = std::max(r.totalSeconds, results[t].totalSeconds);
+        }
+        r.threads = threads;
+        r.frames = frames.size();
+        return r;
+    }
+
+    // Best of the repeats, stage by stage.
+    void keepFastest(Result& best, const Result& r) {
+        best.unpackSeconds = std::min(best.unpackSeconds, r.unpackSeconds);
+        best.findSeconds = std::min(best.findSeconds, r.findSeconds);
+        best.totalSeconds = std::min(best.totalSeconds, r.totalSeconds);
+    }
+
+    double rate(const Result& r, double s) { return r.frames/s; }
+
+    void writeCSV(std::ostream& out, const std::vector<Result>& results) {
+        out << "kernel,unpack_kernel,threads,frames,unpack_frames_per_s,find_frames_per_s,frames_per_s,MBps,"
+            << "links_per_core,primitives,primitives_per_frame\n";
+        for(size_t i=0; i<results.size(); i++) {
+            const Result& r = results[i];
+            out << framegen::hitfinder_kernel() << ',' << framegen::pack_kernel() << ',' << r.threads << ','
+                << r.frames << ',' << rate(r, r.unpackSeconds) << ',' << rate(r, r.findSeconds) << ','
+                << rate(r, r.totalSeconds) << ',' << rate(r, r.totalSeconds)*framegen::num_frame_bytes/1e6 << ','
+                << rate(r, r.totalSeconds)/framegen::nominal_frame_rate << ',' << r.primitives << ','
+                << (double)r.primitives/r.frames << '\n';
+        }
+    }
+
+    void writeJSON(std::ostream& out, const std::vector<Result>& results) {
+        out << "[";
+        for(size_t i=0; i<results.size(); i++) {
+            const Result& r = results[i];
+            out << (i? ",\n ": "\n ") << "{\"kernel\": \"" << framegen::hitfinder_kernel()
+                << "\", \"unpack_kernel\": \"" << framegen::pack_kernel() << "\", \"threads\": " << r.threads
+                << ", \"frames\": " << r.frames << ", \"unpack_frames_per_s\": " << rate(r, r.unpackSeconds)
+                << ", \"find_frames_per_s\": " << rate(r, r.findSeconds)
+                << ", \"frames_per_s\": " << rate(r, r.totalSeconds)
+                << ", \"MBps\": " << rate(r, r.totalSeconds)*framegen::num_frame_bytes/1e6
+                << ", \"links_per_core\": " << rate(r, r.totalSeconds)/framegen::nominal_frame_rate
+                << ", \"primitives\": " << r.primitives
+                << ", \"primitives_per_frame\": " << (double)r.primitives/r.frames << "}";
+        }
+        out << "\n]\n";
+    }
+} // namespace
+
+int main(int argc, char* argv[]) {
+    unsigned long Nframes = 100000;
+    double pedestal = 250, amplitude = 10;
+    framegen::SignalOptions signal;
+    signal.hitRate = 0.5;
+    signal.trackRate = 0.01;
+    signal.showerRate = 0.001;
+    framegen::HitFinderOptions options;
+    std::vector<double> threadCounts(1, 1);
+    unsigned repeat = 3;
+    uint64_t seed = 1;
+    std::string format = "csv", output;
+
+    for(int i=1; i<argc; i++) {
+        const std::string arg = argv[i];
+        if(i+1 >= argc) {
+            std::cout << "Error: option " << arg << " needs a value." << std::endl;
+            return 1;
+        }
+        const std::string value = argv[++i];
+        if(arg == "--frames") Nframes = std::max(1l, atol(value.c_str()));
+        else if(arg == "--pedestal") pedestal = atof(value.c_str());
+        else if(arg == "--amplitude") amplitude = atof(value.c_str());
+        else if(arg == "--hit-rate") signal.hitRate = atof(value.c_str());
+        else if(arg == "--track-rate") signal.trackRate = atof(value.c_str());
+        else if(arg == "--shower-rate") signal.showerRate = atof(value.c_str());
+        else if(arg == "--threshold") options.threshold = atoi(value.c_str());
+        else if(arg == "--pedestal-method" && (value == "median" || value == "mean"))
+            options.pedestal = value == "mean"? framegen::HitFinderOptions::running_mean:
+                framegen::HitFinderOptions::frugal_median;
+        else if(arg == "--threads") threadCounts = numbers(value);
+        else if(arg == "--repeat") repeat = std::max(1, atoi(value.c_str()));
+        else if(arg == "--seed") seed = strtoull(value.c_str(), nullptr, 10);
+        else if(arg == "--format") format = value;
+        else if(arg == "--output") output = value;
+        else {
+            std::cout << "Error: unknown option " << arg << " " << value << "." << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<framegen::Frame> frames;
+    framegen::FrameGen generator;
+    generator.setThreads(0);
+    generator.setPedestal(pedestal);
+    generator.setAmplitude(amplitude);
+    generator.noise().seed(seed);
+    generator.setSignal(signal);
+    generator.generateBuffer(frames, Nframes);
+
+    std::vector<Result> results;
+    for(size_t t=0; t<threadCounts.size(); t++) {
+        const unsigned threads = std::max(1, (int)threadCounts[t]);
+        Result best = run(frames, options, threads);
+        for(unsigned i=1; i<repeat; i++)
+            keepFastest(best, run(frames, options, threads));
+        results.push_back(best);
+        std::cerr << threads << " thread(s), " << framegen::hitfinder_kernel() << ": " << rate(best, best.totalSeconds)
+            << " frames/s per core (" << rate(best, best.totalSeconds)/framegen::nominal_frame_rate
+            << " links), " << (double)best.primitives/best.frames << " primitives per frame" << std::endl;
+    }
+
+    std::ofstream ofile;
+    if(!output.empty()) {
+        ofile.open(output);
+        if(!ofile) {
+            std::cout << "Error: file " << output << " could not be opened." << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = output.empty()? std::cout: ofile;
+    if(format == "json")
+        writeJSON(out, results);
+    else
+        writeCSV(out, results);
+    return 0;
+}
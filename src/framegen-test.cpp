@@ -52,8 +52,15 @@ int main(int argc, char* argv[]) {
     Fr.resetChecksums();
     Fr.print("exampleframes/printed.frame", 'h'); // The 'h' option prints the frame in hexadecimal notation. (No automatic check on this yet.)
     
+    // Inspect frames in place through a view, without copying them out of the buffer that holds them.
+    std::vector<framegen::Frame> buffer(10);
+    std::ifstream ifile("exampleframes/thousand.frame", std::ios::binary);
+    ifile.read(reinterpret_cast<char*>(buffer.data()), buffer.size()*framegen::num_frame_bytes);
+    framegen::ConstFrameView view(buffer[3].data());
+    std::cout << "Frame 3 timestamp: " << view.timestamp() << ", channel 100: " << view.channel(100) << std::endl;
+    
     // Test to generate and print a matrix of frames.
-    framegen::Frame frame;
+    framegen::Frame frame = framegen::Frame();
     std::vector<framegen::Frame> frameV;
     for(int i=0; i<100; i++)
         frameV.push_back(frame);
@@ -0,0 +1,33 @@
+//==========================================================================
+// Name        : Check.hpp
+// Author      : FrameGen contributors
+// Version     :
+// Copyright   : Copyright (c) 2026 FrameGen contributors
+// Description : Minimal checks shared by the test programs.
+//============================================================================
+
+#ifndef FRAMEGEN_TESTS_CHECK_HPP_
+#define FRAMEGEN_TESTS_CHECK_HPP_
+
+#include <iostream>
+
+// Failed checks so far; main() returns check_result().
+static int check_failures = 0;
+
+// Report a failed condition and carry on, so one run lists every failure.
+#define CHECK(condition)                                               \
+  do {                                                                 \
+    if (!(condition)) {                                                \
+      std::cout << __FILE__ << ":" << __LINE__                         \
+                << ": check failed: " #condition << std::endl;         \
+      check_failures++;                                                \
+    }                                                                  \
+  } while (0)
+
+inline int check_result() {
+  if (check_failures)
+    std::cout << check_failures << " check(s) failed." << std::endl;
+  return check_failures ? 1 : 0;
+}
+
+#endif /* FRAMEGEN_TESTS_CHECK_HPP_ */
@@ -0,0 +1,141 @@
+// Codecs: round trips of every registered compressor and level on frames, noise and odd lengths, the wib stored mode,
+// containers with and without their index, and rejection of damaged containers.
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <vector>
+#include "src/CompressedFile.hpp"
+#include "src/FrameGen.hpp"
+#include "src/WIBCodec.hpp"
+#include "tests/Check.hpp"
+
+using namespace framegen;
+
+namespace {
+    bool roundTrip(Compressor& compressor, const uint8_t* data, const size_t bytes) {
+        std::vector<uint8_t> coded;
+        if(!compressor.compress(data, bytes, coded))
+            return false;
+        std::vector<uint8_t> decoded(bytes + 1, 0xA5);
+        return compressor.decompress(coded.data(), coded.size(), decoded.data(), bytes)
+            && std::equal(data, data + bytes, decoded.begin()) && decoded[bytes] == 0xA5;
+    }
+
+    std::string containerOf(const std::string& raw, const CompressOptions& options) {
+        std::istringstream in(raw);
+        std::ostringstream out;
+        CHECK(compressStream(in, out, raw.size(), options));
+        return out.str();
+    }
+
+    bool decompresses(const std::string& container, const std::string& raw) {
+        std::istringstream in(container);
+        std::ostringstream out;
+        return decompressStream(in, out) && out.str() == raw;
+    }
+} // namespace
+
+int main() {
+    TimestampClock clock(1000);
+    FrameGen gen;
+    gen.setClock(clock);
+    std::vector<Frame> frames;
+    gen.generateBuffer(frames, 300);
+    const uint8_t* frameBytes = reinterpret_cast<const uint8_t*>(frames.data());
+    const size_t Nbytes = frames.size()*num_frame_bytes;
+
+    std::mt19937 rng(11);
+    std::vector<uint8_t> noise(Nbytes);
+    for(size_t i=0; i<noise.size(); i++)
+        noise[i] = rng();
+
+    // Every backend and level: whole frames, a torn last frame, a single byte and nothing.
+    std::vector<CompressorInfo> list = compressors();
+    CHECK(list.size() >= 3);
+    for(size_t c=0; c<list.size(); c++) {
+        for(int level=list[c].minLevel; level<=list[c].maxLevel; level++) {
+            std::unique_ptr<Compressor> compressor = makeCompressor(list[c].name, level);
+            CHECK(compressor && compressor->level() == level);
+            if(!compressor)
+                continue;
+            CHECK(roundTrip(*compressor, frameBytes, Nbytes));
+            CHECK(roundTrip(*compressor, frameBytes, Nbytes - 5));
+            CHECK(roundTrip(*compressor, noise.data(), noise.size()));
+            CHECK(roundTrip(*compressor, frameBytes, 1));
+            CHECK(roundTrip(*compressor, frameBytes, 0));
+        }
+    }
+
+    // wib: frames shrink, noise is stored behind one mode byte, and truncation is caught.
+    std::vector<uint8_t> coded;
+    wib_compress(frameBytes, Nbytes, coded);
+    CHECK(coded.size() < Nbytes/2 && coded[0] != wib_stored);
+    std::vector<uint8_t> decoded(Nbytes);
+    CHECK(!wib_decompress(coded.data(), coded.size()-1, decoded.data(), Nbytes));
+    coded.clear();
+    wib_compress(noise.data(), noise.size(), coded);
+    CHECK(coded.size() == noise.size()+1 && coded[0] == wib_stored);
+    CHECK(wib_decompress(coded.data(), coded.size(), decoded.data(), noise.size()) && decoded == noise);
+    CHECK(!wib_decompress(coded.data(), coded.size()-1, decoded.data(), noise.size()));
+
+    // Containers. The header starts with "FGZC" and records the chunk size.
+    const std::string raw(reinterpret_cast<const char*>(frameBytes), Nbytes - 7);
+    CompressOptions options;
+    options.compressor = "wib";
+    options.chunkFrames = 64;
+    const std::string container = containerOf(raw, options);
+    CHECK(container.compare(0, 4, "FGZC") == 0);
+    ContainerHeader header;
+    CHECK(header.deserialize(reinterpret_cast<const uint8_t*>(container.data())));
+    CHECK(header.codec == Codec::wib && header.chunkBytes == 64*num_frame_bytes);
+    CHECK(header.originalSize == raw.size() && header.frameCount == frames.size()-1);
+    CHECK(decompresses(container, raw));
+    options.compressor = "zlib";
+    CHECK(decompresses(containerOf(raw, options), raw));
+
+    // Damaged chunk sizes are refused before anything is allocated for them.
+    const uint32_t badSizes[] = {0, num_frame_bytes + 1, ContainerHeader::max_chunk_bytes + num_frame_bytes};
+    for(size_t i=0; i<3; i++) {
+        std::string damaged = container;
+        for(int b=0; b<4; b++)
+            damaged[8+b] = (char)(badSizes[i] >> 8*b);
+        CHECK(!decompresses(damaged, raw));
+    }
+    // So are flipped payload bits, through the chunk CRC.
+    std::string flipped = container;
+    flipped[ContainerHeader::size + 40] ^= 1;
+    CHECK(!decompresses(flipped, raw));
+    // Containers larger than the limit are not written at all.
+    options.chunkFrames = ContainerHeader::max_chunk_bytes/num_frame_bytes + 1;
+    std::istringstream in(raw);
+    std::ostringstream out;
+    CHECK(!compressStream(in, out, raw.size(), options));
+
+    // Random access through the index, and through a scan when the index is gone.
+    const std::string filename = "test-codecs.fgz";
+    for(int withIndex=1; withIndex>=0; withIndex--) {
+        {
+            std::ofstream file(filename, std::ios::binary);
+            if(withIndex)
+                file << container;
+            else
+                file << container.substr(0, container.size() - ChunkIndexEntry::trailer_size);
+        }
+        CompressedFile compressed(filename);
+        CHECK(compressed.is_open() && compressed.size() == frames.size()-1);
+        CHECK(compressed.index().size() == (frames.size()+63)/64);
+        Frame frame;
+        const size_t picks[] = {0, 63, 64, 200, frames.size()-2};
+        for(size_t i=0; i<5; i++)
+            CHECK(compressed.readFrame(picks[i], frame) && !memcmp(frame.data(), frames[picks[i]].data(), num_frame_bytes));
+        CHECK(!compressed.readFrame(frames.size()-1, frame));
+        std::vector<Frame> range;
+        CHECK(compressed.readRange(frames[100].timestamp(), frames[150].timestamp(), range));
+        CHECK(range.size() == 50 && !memcmp(range[0].data(), frames[100].data(), num_frame_bytes));
+    }
+    std::remove(filename.c_str());
+    return check_result();
+}
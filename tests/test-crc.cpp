@@ -0,0 +1,81 @@
+// CRC engines: known answers, agreement with zlib for every length and alignment, and agreement of the frame
+// functions with the reference bit-by-bit implementations.
+
+#include <random>
+#include <vector>
+#include "src/CRC32.hpp"
+#include "src/FrameGen.hpp"
+#include "tests/Check.hpp"
+
+using namespace framegen;
+
+namespace {
+    // The shift register of the original Frame::calculate_CRC32(), one bit at a time.
+    uint32_t referenceCRC32(const word_t* frame, const uint32_t polynomial) {
+        uint32_t shiftReg = frame[0];
+        if(shiftReg&1)
+            shiftReg ^= polynomial;
+        for(unsigned i=0; i<(num_frame_words-2)*32; i++) {
+            const bool carry = shiftReg & 1;
+            shiftReg = shiftReg>>1 | (frame[i/32+1]>>(i%32)&1)<<31;
+            if(carry)
+                shiftReg ^= polynomial;
+        }
+        return shiftReg;
+    }
+
+    // zlib over the same words, a byte at a time.
+    uint32_t referenceZCRC32(const word_t* frame) {
+        uint32_t crc = crc32(0L, Z_NULL, 0);
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(frame);
+        for(unsigned i=0; i<(num_frame_words-2)*4; i++)
+            crc = crc32(crc, p++, 1);
+        return crc;
+    }
+} // namespace
+
+int main() {
+    std::cout << "CRC kernel: " << crc32_kernel() << std::endl;
+
+    // The standard check value of CRC-32.
+    const char digits[] = "123456789";
+    CHECK(zcrc32(0, digits, 9) == 0xCBF43926u);
+    CHECK(zcrc32(0, digits, 0) == 0);
+    CHECK(zcrc32(0, nullptr, 0) == 0);
+
+    // Lengths around every block size the kernels use, from every alignment, whole and in two parts.
+    std::mt19937 rng(5);
+    std::vector<uint8_t> buffer(4096 + 64);
+    for(size_t i=0; i<buffer.size(); i++)
+        buffer[i] = rng();
+    for(size_t offset=0; offset<16; offset++) {
+        for(size_t n=0; n<=600; n++) {
+            const uint8_t* p = buffer.data() + offset;
+            const uint32_t expected = crc32(0L, p, n);
+            CHECK(zcrc32(0, p, n) == expected);
+            CHECK(zcrc32(zcrc32(0, p, n/3), p + n/3, n - n/3) == expected);
+        }
+        CHECK(zcrc32(0, buffer.data() + offset, 4096) == crc32(0L, buffer.data() + offset, 4096));
+    }
+
+    // Frames, single and batched, against bit-by-bit references.
+    FrameGen gen;
+    std::vector<Frame> frames;
+    gen.generateBuffer(frames, 37);
+    frames[3].set_CRC32(0xDEADBEEF);
+    std::vector<uint32_t> zcrcs(frames.size()), crcs(frames.size());
+    zcrc32_frames(frames[0].data(), frames.size(), zcrcs.data());
+    crc32_frames(frames[0].data(), frames.size(), crcs.data());
+    for(size_t i=0; i<frames.size(); i++) {
+        const uint32_t zref = referenceZCRC32(frames[i].data());
+        const uint32_t ref = referenceCRC32(frames[i].data(), CRC32_POLYNOMIAL);
+        CHECK(zcrc32_frame(frames[i].data()) == zref);
+        CHECK(zcrcs[i] == zref);
+        CHECK(crc32_frame(frames[i].data()) == ref);
+        CHECK(crcs[i] == ref);
+        CHECK(crc32_frame(frames[i].data(), 0x82F63B78) == referenceCRC32(frames[i].data(), 0x82F63B78));
+    }
+    // Generated frames carry the zlib CRC of their contents.
+    CHECK(frames[0].CRC32() == zcrc32_frame(frames[0].data()));
+    return check_result();
+}
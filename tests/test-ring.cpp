@@ -0,0 +1,101 @@
+// Frame ring: capacity rounding, full and empty rings, and every frame arriving exactly once and in order with one
+// or several producers.
+
+#include <thread>
+#include <vector>
+#include "src/FrameRing.hpp"
+#include "tests/Check.hpp"
+
+using namespace framegen;
+
+namespace {
+    // Producers stamp each frame with its number, the consumer checks what arrives.
+    void produce(FrameRing& ring, const uint64_t first, const uint64_t count, const uint64_t stride) {
+        for(uint64_t n=0; n<count; ) {
+            FrameRing::Batch batch = ring.claimWait(std::min<uint64_t>(7, count-n));
+            for(size_t i=0; i<batch.count; i++)
+                batch.frames[i].set_timestamp(first + (n+i)*stride);
+            ring.publish(batch);
+            n += batch.count;
+        }
+    }
+
+    std::vector<uint64_t> consume(FrameRing& ring) {
+        std::vector<uint64_t> seen;
+        for(;;) {
+            FrameRing::Batch batch = ring.peekWait(13);
+            if(!batch.count)
+                return seen;
+            for(size_t i=0; i<batch.count; i++)
+                seen.push_back(batch.frames[i].timestamp());
+            ring.release(batch);
+        }
+    }
+} // namespace
+
+int main() {
+    {
+        FrameRing ring(100);
+        CHECK(ring.valid() && ring.capacity() == 128 && ring.size() == 0);
+        CHECK(ring.peek(4).count == 0);
+        // Batches stop at the end of the ring, so a full ring takes two claims.
+        FrameRing::Batch a = ring.claim(100);
+        CHECK(a.count == 100 && a.position == 0);
+        ring.publish(a);
+        FrameRing::Batch b = ring.claim(100);
+        CHECK(b.count == 28 && b.position == 100);
+        ring.publish(b);
+        CHECK(ring.claim(1).count == 0 && ring.size() == 128);
+        FrameRing::Batch c = ring.peek(200);
+        CHECK(c.count == 128 && c.position == 0);
+        ring.release(c);
+        CHECK(ring.size() == 0 && ring.claim(1).count == 1);
+    }
+
+    // One producer: everything in order.
+    const uint64_t Nframes = 100000;
+    {
+        FrameRing ring(64);
+        std::thread producer([&] { produce(ring, 0, Nframes, 1); ring.close(); });
+        std::vector<uint64_t> seen = consume(ring);
+        producer.join();
+        CHECK(seen.size() == Nframes);
+        bool ordered = true;
+        for(size_t i=0; i<seen.size(); i++)
+            ordered = ordered && seen[i] == i;
+        CHECK(ordered);
+        CHECK(ring.closed() && ring.peekWait(1).count == 0);
+    }
+
+    // Several producers, each writing every Nproducers-th number: each arrives once, in order per producer.
+    {
+        const unsigned Nproducers = 4;
+        FrameRing ring(64, FrameRing::multi_producer);
+        std::vector<std::thread> producers;
+        for(unsigned p=0; p<Nproducers; p++)
+            producers.push_back(std::thread(produce, std::ref(ring), p, Nframes/Nproducers, Nproducers));
+        std::thread closer([&] {
+            for(unsigned p=0; p<Nproducers; p++)
+                producers[p].join();
+            ring.close();
+        });
+        std::vector<uint64_t> seen = consume(ring);
+        closer.join();
+        CHECK(seen.size() == Nframes);
+        std::vector<uint64_t> next(Nproducers);
+        for(unsigned p=0; p<Nproducers; p++)
+            next[p] = p;
+        std::vector<bool> arrived(Nframes, false);
+        bool ok = true;
+        for(size_t i=0; i<seen.size(); i++) {
+            const uint64_t n = seen[i];
+            ok = ok && n < Nframes && !arrived[n] && n == next[n % Nproducers];
+            if(n < Nframes) {
+                arrived[n] = true;
+                next[n % Nproducers] += Nproducers;
+            }
+        }
+        CHECK(ok);
+    }
+    return check_result();
+}
@@ -0,0 +1,110 @@
+// Timestamp index: periodic and sparse lookups against a linear scan, anomaly detection, and the sidecar file.
+
+#include <cstdio>
+#include <unistd.h>
+#include <vector>
+#include "src/FrameFile.hpp"
+#include "src/FrameWriter.hpp"
+#include "src/TimestampIndex.hpp"
+#include "tests/Check.hpp"
+
+using namespace framegen;
+
+namespace {
+    const uint64_t first_timestamp = 5000;
+
+    bool writeFrames(const std::string& filename, const std::vector<Frame>& frames) {
+        FrameWriter writer(filename);
+        return writer.write(frames.data(), frames.size()) && writer.close();
+    }
+
+    uint64_t linearLowerBound(const FrameFile& file, const uint64_t t) {
+        for(size_t i=0; i<file.size(); i++)
+            if(file[i].timestamp() >= t)
+                return i;
+        return file.size();
+    }
+
+    // Every lookup from before the first timestamp to after the last, including ones between frames.
+    void checkLookups(const TimestampIndex& index, const FrameFile& file) {
+        const uint64_t last = file[file.size()-1].timestamp();
+        for(uint64_t t=first_timestamp-30; t<=last+30; t+=7)
+            CHECK(index.lowerBound(file, t) == linearLowerBound(file, t));
+    }
+} // namespace
+
+int main() {
+    TimestampClock clock(first_timestamp);
+    FrameGen gen;
+    gen.setClock(clock);
+    std::vector<Frame> frames;
+    gen.generateBuffer(frames, 1000);
+    const std::string filename = "test-timestamp-index.frames";
+    const std::string sidecar = filename + ".tsidx";
+    TimestampIndexOptions options;
+    options.stride = 16;
+
+    // Evenly spaced: computed without the file.
+    CHECK(writeFrames(filename, frames));
+    {
+        FrameFile file(filename);
+        TimestampIndex index;
+        CHECK(index.build(file, options));
+        CHECK(index.periodic() && index.period() == frame_timestamp_step);
+        CHECK(index.size() == frames.size() && index.firstTimestamp() == first_timestamp);
+        CHECK(index.samples().size() == (frames.size()+15)/16 && index.anomalies().empty());
+        CHECK(index.lowerBound(file, first_timestamp + 10*frame_timestamp_step) == 10);
+        CHECK(index.lowerBound(file, first_timestamp + 10*frame_timestamp_step + 1) == 11);
+        checkLookups(index, file);
+    }
+
+    // A gap after frame 300 and a frame out of order at 700.
+    for(size_t i=300; i<frames.size(); i++)
+        frames[i].set_timestamp(frames[i].timestamp() + 1000*frame_timestamp_step);
+    frames[700].set_timestamp(frames[650].timestamp());
+    CHECK(writeFrames(filename, frames));
+    {
+        FrameFile file(filename);
+        TimestampIndex index;
+        CHECK(index.build(file, options));
+        // Frame 701 jumps forward again from the early frame before it.
+        CHECK(!index.periodic() && index.gaps() == 2 && index.outOfOrder() == 1);
+        CHECK(index.anomalies().size() == 3);
+        CHECK(index.anomalies()[0].kind == TimestampAnomaly::gap && index.anomalies()[0].frame == 300);
+        CHECK(index.lowerBound(file, frames[300].timestamp() - 1) == 300);
+        CHECK(index.lowerBound(file, frames[150].timestamp()) == 150);
+
+        // The sidecar keeps the lookups but not the list of anomalies.
+        CHECK(index.save(sidecar));
+        TimestampIndex loaded;
+        CHECK(loaded.load(sidecar));
+        CHECK(loaded.size() == index.size() && loaded.samples() == index.samples());
+        CHECK(loaded.gaps() == 2 && loaded.outOfOrder() == 1 && loaded.anomalies().empty());
+        for(uint64_t t=first_timestamp; t<frames[299].timestamp(); t+=frame_timestamp_step/2)
+            CHECK(loaded.lowerBound(file, t) == linearLowerBound(file, t));
+
+        // open() takes the sidecar only for the same stride.
+        TimestampIndex opened;
+        CHECK(opened.open(file, options) && opened.stride() == 16 && opened.anomalies().empty());
+        TimestampIndexOptions other = options;
+        other.stride = 8;
+        CHECK(opened.open(file, other) && opened.stride() == 8 && opened.samples().size() == (frames.size()+7)/8);
+    }
+
+    // A sidecar whose sample count does not fit its size is refused.
+    {
+        std::FILE* f = std::fopen(sidecar.c_str(), "r+b");
+        CHECK(f != nullptr);
+        if(f) {
+            std::fseek(f, 0, SEEK_END);
+            const long size = std::ftell(f);
+            std::fclose(f);
+            CHECK(truncate(sidecar.c_str(), size - 8) == 0);
+        }
+        TimestampIndex truncated;
+        CHECK(!truncated.load(sidecar));
+    }
+    std::remove(filename.c_str());
+    std::remove(sidecar.c_str());
+    return check_result();
+}